@@ -0,0 +1,140 @@
+#include "constants.h"
+#include "attack_table.h"
+
+
+template <class G>
+const int BasicAttackTable<G>::REVERSE_CAPTURE;
+
+
+// Public
+// ------
+template <class G>
+BasicAttackTable<G>::BasicAttackTable(const PieceLibrary& plib) : m_pieces(plib.size()) {
+	int entries = (REVERSE_CAPTURE + 1) * 2 * m_pieces;
+	m_leaps.assign(entries * G::SQUARES, Bitboard(0));
+	m_sliderBegin.assign(entries, 0);
+	m_sliderEnd.assign(entries, 0);
+	for (int kind = 0; kind <= REVERSE_CAPTURE; ++kind) {
+		bool reverse = (kind == REVERSE_CAPTURE);
+		for (int side = WHITE; side <= BLACK; ++side) {
+			for (int piece = 0; piece < m_pieces; ++piece) {
+				int e = entry(kind, piece, side);
+				m_sliderBegin[e] = int(m_sliderRays.size());
+				for (const Offset& o : plib.getOffsets(plib.getPiece(piece), reverse ? OFFSET_CAPTURE : OffsetKind(kind))) {
+					int forward = (side == WHITE) ? o.forward : -o.forward;	//Black faces opposite direction
+					int right = o.right;
+					if (reverse) {	//trace from the target back to the attacker
+						forward = -forward;
+						right = -right;
+					}
+					if ((forward == 0 && right == 0) || o.range < 1) {	//can't go anywhere
+						continue;
+					}
+					if (o.range == 1) {
+						for (Square sq = 0; sq < G::SQUARES; ++sq) {
+							Square next = G::makeSquare(G::rowOf(sq) + forward, G::colOf(sq) + right);
+							if (next != NO_SQUARE) {
+								m_leaps[e * G::SQUARES + sq] |= G::squareBit(next);
+							}
+						}
+					} else {
+						m_sliderRays.push_back(findRay(forward, right, o.range));
+					}
+				}
+				m_sliderEnd[e] = int(m_sliderRays.size());
+			}
+		}
+	}
+}
+
+template <class G>
+typename BasicAttackTable<G>::Bitboard BasicAttackTable<G>::attacks(const OffsetKind& kind, const int& piece, const int& side, const Square& sq, const Bitboard& occupied) const {
+	return lookup(entry(kind, piece, side), sq, occupied);
+}
+
+template <class G>
+typename BasicAttackTable<G>::Bitboard BasicAttackTable<G>::attackers(const int& piece, const int& side, const Square& sq, const Bitboard& occupied) const {
+	//a ray from sq stopping at the first occupied square is exactly the set of squares whose ray reaches sq
+	return lookup(entry(REVERSE_CAPTURE, piece, side), sq, occupied);
+}
+
+template <class G>
+void BasicAttackTable<G>::pins(const int& piece, const int& side, const Square& target, const Bitboard& occupied, const Bitboard& attackers,
+	const Bitboard& defenders, Bitboard& pinned, Bitboard pinLines[G::SQUARES], Bitboard& checkLines) const {
+	int e = entry(REVERSE_CAPTURE, piece, side);
+	for (int i = m_sliderBegin[e]; i < m_sliderEnd[e]; ++i) {
+		const Ray& ray = m_rays[m_sliderRays[i]];
+		Bitboard squares = ray.squares[target];
+		Bitboard blockers = squares & occupied;
+		if (!blockers) {
+			continue;
+		}
+		Square first = ray.ascending ? lsb(blockers) : msb(blockers);
+		if (attackers & G::squareBit(first)) {	//checking: blocking squares lie between target and first
+			checkLines |= squares & ~ray.squares[first] & ~G::squareBit(first);
+			continue;
+		}
+		blockers &= ray.squares[first];	//look past first
+		if (!(defenders & G::squareBit(first)) || !blockers) {
+			continue;
+		}
+		Square second = ray.ascending ? lsb(blockers) : msb(blockers);
+		if (attackers & G::squareBit(second)) {	//first is the only thing between target and second
+			Bitboard line = squares & ~ray.squares[second];
+			pinLines[first] = (pinned & G::squareBit(first)) ? (pinLines[first] & line) : line;	//pinned along several rays
+			pinned |= G::squareBit(first);
+		}
+	}
+}
+
+// Private
+// -------
+template <class G>
+int BasicAttackTable<G>::entry(const int& kind, const int& piece, const int& side) const {
+	return (kind * 2 + side) * m_pieces + piece;
+}
+
+template <class G>
+typename BasicAttackTable<G>::Bitboard BasicAttackTable<G>::lookup(const int& e, const Square& sq, const Bitboard& occupied) const {
+	Bitboard result = m_leaps[e * G::SQUARES + sq];
+	for (int i = m_sliderBegin[e]; i < m_sliderEnd[e]; ++i) {
+		const Ray& ray = m_rays[m_sliderRays[i]];
+		Bitboard squares = ray.squares[sq];
+		Bitboard blockers = squares & occupied;
+		if (blockers) {	//cut the ray off past the nearest blocker
+			squares &= ~ray.squares[ray.ascending ? lsb(blockers) : msb(blockers)];
+		}
+		result |= squares;
+	}
+	return result;
+}
+
+template <class G>
+int BasicAttackTable<G>::findRay(const int& forward, const int& right, const int& range) {
+	for (int i = 0; i < int(m_rays.size()); ++i) {
+		if (m_rays[i].forward == forward && m_rays[i].right == right && m_rays[i].range == range) {
+			return i;
+		}
+	}
+	Ray ray;
+	ray.forward = forward;
+	ray.right = right;
+	ray.range = range;
+	ray.ascending = (forward * G::SIZE + right) > 0;
+	for (Square sq = 0; sq < G::SQUARES; ++sq) {
+		ray.squares[sq] = 0;
+		Square next = G::makeSquare(G::rowOf(sq) + forward, G::colOf(sq) + right);
+		for (int steps = 0; next != NO_SQUARE && steps < range; ++steps) {
+			ray.squares[sq] |= G::squareBit(next);
+			next = G::makeSquare(G::rowOf(next) + forward, G::colOf(next) + right);
+		}
+	}
+	m_rays.push_back(ray);
+	return int(m_rays.size()) - 1;
+}
+
+// Instantiations
+// --------------
+template class BasicAttackTable<Geometry<8>>;
+template class BasicAttackTable<Geometry<10>>;
+template class BasicAttackTable<Geometry<12>>;
@@ -0,0 +1,144 @@
+#ifndef ATTACK_TABLE_H
+#define ATTACK_TABLE_H
+
+#include <vector>
+
+#include "bitboard.h"
+#include "piece_library.h"
+
+
+/*
+	@brief		attack masks of every piece on a board of geometry G
+*/
+template <class G>
+class BasicAttackTable {
+public:
+	/*
+		@brief		set of squares of the board, one bit per Square
+	*/
+	typedef typename G::Mask Bitboard;
+
+	/*
+		@brief		precomputes attack masks for every piece, side, offset kind and square from the compiled PieceLibrary
+					single-step offsets (leapers) are merged into one mask per square,
+					repeatable offsets (sliders) get one ray mask per square so blockers can be found with a bit scan
+					capture offsets are also stored inverted so attacks can be traced backwards from a target
+	*/
+	BasicAttackTable(const PieceLibrary& plib);
+
+	/*
+		@param		kind		type of offsets, e.g. move or capture
+		@param		piece		index of piece in PieceLibrary
+		@param		side		enum of White or Black (offsets are mirrored for Black)
+		@param		sq			square the piece stands on
+		@param		occupied	every occupied square on the board
+
+		@return		squares reachable from sq, stopping at (and including) the first occupied square of every ray
+	*/
+	Bitboard attacks(const OffsetKind& kind, const int& piece, const int& side, const Square& sq, const Bitboard& occupied) const;
+
+	/*
+		@param		piece		index of piece in PieceLibrary
+		@param		side		enum of White or Black the attacking piece belongs to
+		@param		sq			square being attacked
+		@param		occupied	every occupied square on the board
+
+		@return		squares from which a piece of type piece belonging to side could capture sq
+	*/
+	Bitboard attackers(const int& piece, const int& side, const Square& sq, const Bitboard& occupied) const;
+
+	/*
+		@brief		traces every repeatable capture offset of piece backwards from target to find pins and checking lines
+					a defender is pinned if it is the only piece between target and an attacker along one of these rays
+
+
+		@param		piece		index of piece in PieceLibrary
+		@param		side		enum of White or Black the attacking piece belongs to
+		@param		target		square of the royal piece being attacked
+		@param		occupied	every occupied square on the board
+		@param		attackers	squares of pieces of type piece belonging to side
+		@param		defenders	squares of pieces belonging to the side of target
+		@param		pinned		receives the squares of pinned defenders
+		@param		pinLines	for every pinned square, receives the squares it may still move to (up to and including the attacker)
+		@param		checkLines	receives the empty squares between target and any attacker checking it along a ray
+	*/
+	void pins(const int& piece, const int& side, const Square& target, const Bitboard& occupied, const Bitboard& attackers,
+		const Bitboard& defenders, Bitboard& pinned, Bitboard pinLines[G::SQUARES], Bitboard& checkLines) const;
+
+private:
+	/*
+		@brief		extra kind, after the OffsetKinds, holding capture offsets pointing backwards
+	*/
+	static const int REVERSE_CAPTURE = OFFSET_KINDS;
+
+	/*
+		@param		kind		type of offsets (or REVERSE_CAPTURE)
+		@param		piece		index of piece in PieceLibrary
+		@param		side		enum of White or Black
+
+		@return		index of the (kind, side, piece) entry in m_leaps and m_sliders
+	*/
+	int entry(const int& kind, const int& piece, const int& side) const;
+
+	/*
+		@param		e			entry from entry()
+		@param		sq			square to trace from
+		@param		occupied	every occupied square on the board
+
+		@return		union of the leaper mask and every blocked ray of entry e from sq
+	*/
+	Bitboard lookup(const int& e, const Square& sq, const Bitboard& occupied) const;
+
+	/*
+		@param		forward		offset in forward direction (already mirrored by side)
+		@param		right		offset in right direction
+		@param		range		number of times the offset can be repeated
+
+		@return		index of a ray in m_rays, built the first time a direction and range is seen
+	*/
+	int findRay(const int& forward, const int& right, const int& range);
+
+	/*
+		@brief		a repeatable offset; squares along a ray are strictly increasing or decreasing,
+					so the nearest blocker is the lowest or highest bit of ray & occupied
+	*/
+	struct Ray {
+		int forward;
+		int right;
+		int range;
+		bool ascending;
+		Bitboard squares[G::SQUARES];
+	};
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		number of pieces in the PieceLibrary the table was built from
+	*/
+	int m_pieces;
+
+	/*
+		@brief		union of all single-step offsets for every entry and square
+	*/
+	std::vector<Bitboard> m_leaps;
+
+	/*
+		@brief		[begin, end) into m_sliderRays for every entry
+	*/
+	std::vector<int> m_sliderBegin;
+	std::vector<int> m_sliderEnd;
+
+	/*
+		@brief		indices into m_rays of every repeatable offset, stored contiguously by entry
+	*/
+	std::vector<int> m_sliderRays;
+
+	/*
+		@brief		every distinct ray direction and range used by the library
+	*/
+	std::vector<Ray> m_rays;
+};
+
+typedef BasicAttackTable<BoardGeometry> AttackTable;
+
+#endif ATTACK_TABLE_H
@@ -0,0 +1,85 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <vector>
+
+#include "square.h"
+
+
+/*
+	@brief		set of squares, one bit per Square (bit 0 is a1)
+				the helpers below take the mask of any Geometry, so boards of other sizes can use them too
+*/
+typedef BoardGeometry::Mask Bitboard;
+
+/*
+	@param		sq			square on the board
+
+	@return		bitboard with only sq set
+*/
+inline Bitboard squareBit(const Square& sq) {
+	return BoardGeometry::squareBit(sq);
+}
+
+/*
+	@param		b			non-empty bitboard
+
+	@return		lowest square set in b
+*/
+template <class Mask>
+inline Square lsb(const Mask& b) {
+	return Square(lowestBit(b));
+}
+
+/*
+	@param		b			non-empty bitboard
+
+	@return		highest square set in b
+*/
+template <class Mask>
+inline Square msb(const Mask& b) {
+	return Square(highestBit(b));
+}
+
+/*
+	@param		b			non-empty bitboard, lowest square is removed
+
+	@return		lowest square that was set in b
+*/
+template <class Mask>
+inline Square popLsb(Mask& b) {
+	Square sq = lsb(b);
+	b = withoutLowestBit(b);
+	return sq;
+}
+
+/*
+	@param		b			bitboard
+
+	@return		number of squares set in b
+*/
+template <class Mask>
+inline int popCount(Mask b) {
+	int count = 0;
+	for (; b; b = withoutLowestBit(b)) {
+		++count;
+	}
+	return count;
+}
+
+/*
+	@param		b			bitboard
+
+	@return		every square set in b, in ascending order
+*/
+template <class Mask>
+inline std::vector<Square> toSquares(Mask b) {
+	std::vector<Square> squares;
+	while (b) {
+		squares.push_back(popLsb(b));
+	}
+	return squares;
+}
+
+#endif BITBOARD_H
@@ -1,117 +1,266 @@
 ﻿#include <iostream>     // std::cout
 #include <algorithm>	// std::copy
+#include <iomanip>		// std::setw
 #include "board.h"
 
 
 // Public
 // ------
-Board::Board() : m_plib(), m_rules() {
+template <class G>
+BasicBoard<G>::BasicBoard(const std::string& rules) : m_registry(BasicRulesRegistry<G>::get()), m_plib(&m_registry->pieces()),
+	m_attacks(&m_registry->attacks()), m_zobrist(&m_registry->zobrist()), m_rules(&m_registry->rules().getRules(rules)) {
 	reset();
 }
 
-void Board::reset(const std::string& newRules) {
-	if (!newRules.empty()) {
-		m_rules.setRules(newRules);
+template <class G>
+void BasicBoard<G>::reset(const std::string& newRules) {
+	//only selected once they are known to be usable, so a failed reset leaves the board as it was
+	const CompiledRules* rules = newRules.empty() ? m_rules : &m_registry->rules().getRules(newRules);
+	if (rules->size != G::SIZE) {
+		throw std::invalid_argument("Rules are for a " + std::to_string(rules->size) + "x" + std::to_string(rules->size) + " board, but the board is "
+			+ std::to_string(G::SIZE) + "x" + std::to_string(G::SIZE) + ". Rules cannot be used.");
 	}
-	for (int i = 0; i < BOARD_SIZE; ++i) {
-		for (int j = 0; j < BOARD_SIZE; ++j) {
-			m_board[i][j] = m_rules.getInitialBoardAt(i, j);//copy initial to board (length 1 string is a char)
-			m_neverMoved[i][j] = (m_board[i][j] != EMPTY);	//reset neverMoved; only positions with pieces are eligible
+	Snapshot initial;
+	initial.neverMoved = 0;
+	initial.turn = FIRST_TURN;
+	for (int i = 0; i < G::SIZE; ++i) {
+		for (int j = 0; j < G::SIZE; ++j) {
+			Square sq = G::makeSquare(i, j);
+			initial.board[sq] = rules->board[i * G::SIZE + j];
+			if (initial.board[sq] != EMPTY) {	//only positions with pieces are eligible for neverMoved
+				if (!m_plib->contains(initial.board[sq])) {
+					throw std::invalid_argument("Unidentified piece on the board. Rules cannot be used.");
+				}
+				initial.neverMoved |= G::squareBit(sq);
+			}
 		}
-	}		//m_board_backup & m_neverMoved_backup can have anything as they are overwritten often
+	}
+	m_rules = rules;
+	m_royalPiece[WHITE] = m_rules->royal[WHITE];
+	m_royalPiece[BLACK] = m_rules->royal[BLACK];
+	place(initial);
+}
+
+template <class G>
+typename BasicBoard<G>::Snapshot BasicBoard<G>::snapshot() const {
+	Snapshot snapshot;
+	std::copy(m_board, m_board + SQUARES, snapshot.board);
+	snapshot.neverMoved = m_neverMoved;
+	snapshot.turn = m_turn;
+	snapshot.hash = m_hash;
+	return snapshot;
+}
+
+template <class G>
+bool BasicBoard<G>::restore(const Snapshot& snapshot) {
+	for (Square sq = 0; sq < SQUARES; ++sq) {
+		if (snapshot.board[sq] != EMPTY && !m_plib->contains(snapshot.board[sq])) {
+			return false;
+		}
+	}
+	if (snapshot.turn != WHITE && snapshot.turn != BLACK) {
+		return false;
+	}
+	place(snapshot);
+	if (m_hash != snapshot.hash) {	//recomputed hash doesn't match: snapshot is damaged
+		reset();
+		return false;
+	}
+	return true;
+}
+
+template <class G>
+void BasicBoard<G>::printRules() {
+	m_registry->rules().printAll();
+}
+
+template <class G>
+std::vector<std::string> BasicBoard<G>::listRules() const {
+	return m_registry->rules().getNames();
+}
+
+template <class G>
+typename BasicBoard<G>::Bitboard BasicBoard<G>::piecesOf(const int& side) const {
+	return m_sides[side];
+}
+
+template <class G>
+const PieceLibrary& BasicBoard<G>::pieces() const {
+	return *m_plib;
+}
+
+template <class G>
+const BasicAttackTable<G>& BasicBoard<G>::attacks() const {
+	return *m_attacks;
+}
+
+template <class G>
+const char& BasicBoard<G>::pieceAt(const Square& pos) const {
+	return m_board[pos];
+}
+
+template <class G>
+int BasicBoard<G>::turn() const {
+	return m_turn;
 }
 
-void Board::printRules() {
-	m_rules.printAll();
+template <class G>
+uint64_t BasicBoard<G>::hash() const {
+	return m_hash;
 }
 
-void Board::validateCurrent(const std::string& current, const int& turn) const {
-	if (!onBoard(current)) {
-		throw std::invalid_argument("Current coordinates are invalid. Try again.");
+template <class G>
+MoveStatus BasicBoard<G>::checkCurrent(const Square& current, const int& turn) const noexcept {
+	if (current == NO_SQUARE) {
+		return MOVE_CURRENT_OFF_BOARD;
 	} else if (isEmpty(current)) {
-		throw std::invalid_argument("Current coordinates are empty. Try again.");
+		return MOVE_EMPTY_SQUARE;
 	} else if (whichSide(pieceAt(current)) != turn) {
-		throw std::invalid_argument("Not one of your pieces. Try again.");
+		return MOVE_WRONG_SIDE;
 	}
+	return MOVE_OK;
 }
 
-void Board::validateFuture(const std::string& future, const int & turn) const {
-	if (!onBoard(future)) {
-		throw std::invalid_argument("Future coordinates are invalid. Try again.");
+template <class G>
+MoveStatus BasicBoard<G>::checkFuture(const Square& future) const noexcept {
+	return (future == NO_SQUARE) ? MOVE_FUTURE_OFF_BOARD : MOVE_OK;
+}
+
+template <class G>
+void BasicBoard<G>::validateCurrent(const Square& current, const int& turn) const {
+	MoveStatus status = checkCurrent(current, turn);
+	if (status != MOVE_OK) {
+		throw std::invalid_argument(describe(status, current));
 	}
 }
 
-std::vector<std::string> Board::listMoves(const std::string& current) {
-	//no allowable intermediates
-	//maximum positions that can be travelled is 1 less than the board size
-	std::vector<std::string> combinedMoves = listFuture(current, PIECE_MOVE_ARRAY, &Board::isEmpty, &Board::rejectAll, BOARD_SIZE - 1);
-	if (neverMovedAt(current)) {	//add any additional initial moves
-		for (const std::string& initial : listFuture(current, PIECE_INITIAL_ARRAY, &Board::isEmpty, &Board::rejectAll, BOARD_SIZE - 1)) {
-			combinedMoves.push_back(initial);
-		}
+template <class G>
+void BasicBoard<G>::validateFuture(const Square& future, const int&) const {	//turn is kept for symmetry with validateCurrent
+	MoveStatus status = checkFuture(future);
+	if (status != MOVE_OK) {
+		throw std::invalid_argument(describe(status, NO_SQUARE));
 	}
-	return combinedMoves;
 }
 
-std::vector<std::string> Board::listCaptures(const std::string& current) {
-	//an empty position is an allowable intermediate
-	return listFuture(current, PIECE_CAPTURE_ARRAY, &Board::isEnemy, &Board::isEmpty, 1);
+template <class G>
+std::string BasicBoard<G>::describe(const MoveStatus& status, const Square& current) const {
+	switch (status) {
+	case MOVE_CURRENT_OFF_BOARD:
+		return "Current coordinates are invalid. Try again.";
+	case MOVE_FUTURE_OFF_BOARD:
+		return "Future coordinates are invalid. Try again.";
+	case MOVE_EMPTY_SQUARE:
+		return "Current coordinates are empty. Try again.";
+	case MOVE_WRONG_SIDE:
+		return "Not one of your pieces. Try again.";
+	case MOVE_INTO_CHECK:
+		return "Move would put " + m_plib->getName(pieceAt(findRoyal(whichSide(pieceAt(current))))) + " in check. Try again.";
+	default:
+		return "Illegal move. Try again.";
+	}
 }
 
-bool Board::inCheck(const int& side) {
-	for (char row = FIRST_ROW; row < char(FIRST_ROW + BOARD_SIZE); ++row) {
-		for (char col = FIRST_COL; col < char(FIRST_COL + BOARD_SIZE); ++col) {
-			std::string otherPos;
-			otherPos += col;
-			otherPos += row;
-			if (isEnemy(otherPos, findRoyal(side))) {	//every piece that is an enemy to pos
-				for (const auto& c : listCaptures(otherPos)) {	//see if any could capture pos
-					if (findRoyal(side) == c) {
-						return true;
-					}
-				}
-			}
+template <class G>
+std::vector<Square> BasicBoard<G>::listMoves(const Square& current) {
+	return toSquares(moveTargets(current));
+}
+
+template <class G>
+std::vector<Square> BasicBoard<G>::listCaptures(const Square& current) {
+	return toSquares(captureTargets(current));
+}
+
+template <class G>
+bool BasicBoard<G>::inCheck(const int& side) {
+	Square royal = findRoyal(side);
+	return royal != NO_SQUARE && isSquareAttacked(royal, !side);	//nothing to capture if there is no royal
+}
+
+template <class G>
+bool BasicBoard<G>::isSquareAttacked(const Square& target, const int& bySide) const {
+	Bitboard occ = occupied();
+	for (int piece = 0; piece < m_plib->size(); ++piece) {
+		Bitboard candidates = m_pieces[piece] & m_sides[bySide];
+		//trace captures of this piece type backwards from target
+		if (candidates && (m_attacks->attackers(piece, bySide, target, occ) & candidates)) {
+			return true;
 		}
 	}
 	return false;	//not at risk
 }
 
-bool Board::wouldBeCheck(const std::string& current, const std::string& future) {
-	freeze();
-	execMove(current, future);
-	bool check = inCheck(whichSide(pieceAt(current)));
-	unfreeze();	//order matters
+template <class G>
+bool BasicBoard<G>::wouldBeCheck(const Square& current, const Square& future) {
+	int side = whichSide(pieceAt(current));
+	Undo undo = makeMove(current, future);
+	bool check = inCheck(side);
+	unmakeMove(undo);
 	return check;
 }
 
-bool Board::inCheckMate(const int& side) {
-	for (char row = FIRST_ROW; row < char(FIRST_ROW + BOARD_SIZE); ++row) {
-		for (char col = FIRST_COL; col < char(FIRST_COL + BOARD_SIZE); ++col) {
-			std::string otherPos;
-			otherPos += col;
-			otherPos += row;
-			if (isFriendly(otherPos, findRoyal(side))) {	//every piece belonging to pos's side
-				for (const auto& m : listMoves(otherPos)) {	//check every move to end check
-					if (!wouldBeCheck(otherPos, m)) {
-						return false;
-					}
+template <class G>
+std::vector<Move> BasicBoard<G>::generateLegalMoves(const int& side) {
+	std::vector<Move> legal;
+	Bitboard occ = occupied();
+	//pins and checks on the royal piece, derived from the enemy's repeatable capture offsets
+	Square royal = findRoyal(side);
+	Bitboard checkers = 0, pinned = 0, checkLines = 0;
+	Bitboard pinLines[SQUARES];	//only valid where pinned is set
+	if (royal != NO_SQUARE) {
+		checkers = attackersOf(royal, !side);
+		for (int piece = 0; piece < m_plib->size(); ++piece) {
+			Bitboard enemies = m_pieces[piece] & m_sides[!side];
+			if (enemies) {
+				m_attacks->pins(piece, !side, royal, occ, enemies, m_sides[side], pinned, pinLines, checkLines);
+			}
+		}
+	}
+	int checks = popCount(checkers);
+	for (Bitboard pieces = m_sides[side]; pieces;) {
+		Square current = popLsb(pieces);
+		Bitboard moves = listFuture(current, OFFSET_MOVE) & ~occ;
+		Bitboard initial = 0;
+		if (neverMovedAt(current)) {	//initial moves are only tagged as such if they aren't ordinary moves too
+			initial = listFuture(current, OFFSET_INITIAL) & ~occ & ~moves;
+		}
+		Bitboard captures = listFuture(current, OFFSET_CAPTURE) & m_sides[!side];
+		const Bitboard targets[] = { moves, captures, initial };	//indexed by MoveType
+		Bitboard allowed = (pinned & G::squareBit(current)) ? pinLines[current] : ~Bitboard(0);	//pinned pieces stay on their line
+		for (int type = MOVE_NORMAL; type <= MOVE_INITIAL; ++type) {
+			for (Bitboard futures = targets[type]; futures;) {
+				Square future = popLsb(futures);
+				bool isLegal;
+				if (current == royal) {	//royal can walk into (or along) an attack: test it
+					isLegal = !wouldBeCheck(current, future);
+				} else if (!(allowed & G::squareBit(future))) {
+					isLegal = false;
+				} else if (!checkers || (checks == 1 && (checkers & G::squareBit(future)))) {	//not in check, or capturing the only checker
+					isLegal = true;
+				} else if ((checkers | checkLines) & G::squareBit(future)) {	//might block or capture every checker: test it
+					isLegal = !wouldBeCheck(current, future);
+				} else {	//leaves every checker where it is with its line open
+					isLegal = false;
 				}
-				for (const auto& c : listCaptures(otherPos)) {	//check every capture to end check
-					if (!wouldBeCheck(otherPos, c)) {
-						return false;
-					}
+				if (isLegal) {
+					legal.push_back({ current, future, MoveType(type) });
 				}
 			}
 		}
 	}
-	return true;	//ded
+	return legal;
+}
+
+template <class G>
+bool BasicBoard<G>::inCheckMate(const int& side) {
+	return generateLegalMoves(side).empty();	//ded if nothing is legal
 }
 
-bool Board::preMove(const int& side) {
+template <class G>
+bool BasicBoard<G>::preMove(const int& side, const std::vector<Move>& legal) {
 	//Checkmate?
-	if (inCheckMate(side)) {
+	if (legal.empty()) {
 		std::cout << std::endl << "Checkmate!" << std::endl
-			<< m_plib.getName(pieceAt(findRoyal(side))) << ", the royal piece, cannot escape capture." << std::endl;
+			<< m_plib->getName(pieceAt(findRoyal(side))) << ", the royal piece, cannot escape capture." << std::endl;
 		if (whichSide(pieceAt(findRoyal(side))) == WHITE) {
 			std::cout << "Black wins.";
 		} else if (whichSide(pieceAt(findRoyal(side))) == BLACK) {
@@ -121,7 +270,7 @@ bool Board::preMove(const int& side) {
 	}
 	//Check?
 	if (inCheck(side)) {
-		std::cout << "Warning: " << m_plib.getName(pieceAt(findRoyal(side))) << " is in check." << std::endl;
+		std::cout << "Warning: " << m_plib->getName(pieceAt(findRoyal(side))) << " is in check." << std::endl;
 	}
 	if (side == WHITE) {
 		std::cout << std::endl << "White's turn (UPPERCASE PIECES)";
@@ -131,179 +280,226 @@ bool Board::preMove(const int& side) {
 	return true;
 }
 
-bool Board::attemptMove(const std::string& current, const std::string& future, const bool& silent) {
-	if (isLegal(current, future, &Board::listMoves)) {
-		if (!silent) {
-			std::cout << "> " << m_plib.getName(pieceAt(current)) << " moved from " << current << " to " << future << "." << std::endl;
-		}
-		execMove(current, future);
-		return true;	//single turn over; TODO: count down multiple turns
-	} else if (isLegal(current, future, &Board::listCaptures)) {
-		if (!silent) {
-			std::cout << "> " << m_plib.getName(pieceAt(current)) << " at " << current << " captured "
-				<< m_plib.getName(pieceAt(future)) << " at " << future << std::endl;
+template <class G>
+bool BasicBoard<G>::attemptMove(const Square& current, const Square& future, const bool& silent, Undo* undo) {
+	MoveStatus status = legality(current, future);
+	if (status != MOVE_OK) {
+		throw std::invalid_argument(describe(status, current));
+	}
+	if (!silent && isEmpty(future)) {
+		std::cout << "> " << m_plib->getName(pieceAt(current)) << " moved from " << G::toAlgebraic(current, FIRST_COL, FIRST_ROW)
+			<< " to " << G::toAlgebraic(future, FIRST_COL, FIRST_ROW) << "." << std::endl;
+	} else if (!silent) {
+		std::cout << "> " << m_plib->getName(pieceAt(current)) << " at " << G::toAlgebraic(current, FIRST_COL, FIRST_ROW) << " captured "
+			<< m_plib->getName(pieceAt(future)) << " at " << G::toAlgebraic(future, FIRST_COL, FIRST_ROW) << std::endl;
+	}
+	Undo made = makeMove(current, future);
+	if (undo) {
+		*undo = made;
+	}
+	return true;	//single turn over; TODO: count down multiple turns
+}
+
+template <class G>
+MoveStatus BasicBoard<G>::tryMove(const Square& current, const Square& future, const int& turn, Undo* undo) noexcept {
+	MoveStatus status = checkCurrent(current, turn);
+	if (status == MOVE_OK) {
+		status = checkFuture(future);
+	}
+	if (status == MOVE_OK) {
+		status = legality(current, future);
+	}
+	if (status == MOVE_OK) {
+		Undo made = makeMove(current, future);
+		if (undo) {
+			*undo = made;
 		}
-		execMove(current, future);
-		return true;
-	} else {	//must fail both move and capture before throwing
-		throw std::invalid_argument("Illegal move. Try again.");
 	}
+	return status;
 }
 
-void Board::print() const {
-	std::cout << "  + --------------- +" << std::endl;
-	for (int i = BOARD_SIZE - 1; i >= 0; --i) {	//reverse order so row 1 prints last
-		std::cout << char(i + FIRST_ROW) << " | ";	//row label
-		for (int j = 0; j < BOARD_SIZE; ++j) {
+template <class G>
+typename BasicBoard<G>::Undo BasicBoard<G>::makeMove(const Square& current, const Square& future) {
+	Undo undo;
+	undo.current = current;
+	undo.future = future;
+	undo.captured = pieceAt(future);
+	undo.currentNeverMoved = neverMovedAt(current);
+	undo.futureNeverMoved = neverMovedAt(future);
+	setPiece(future, pieceAt(current));
+	setPiece(current, EMPTY);
+	setNeverMovedAt(current, false);	//no initial move can be made from current or future now
+	setNeverMovedAt(future, false);
+	m_turn = !m_turn;
+	m_hash ^= m_zobrist->blackToMove();
+	return undo;
+}
+
+template <class G>
+void BasicBoard<G>::unmakeMove(const Undo& undo) {
+	setPiece(undo.current, pieceAt(undo.future));
+	setPiece(undo.future, undo.captured);
+	setNeverMovedAt(undo.current, undo.currentNeverMoved);
+	setNeverMovedAt(undo.future, undo.futureNeverMoved);
+	m_turn = !m_turn;
+	m_hash ^= m_zobrist->blackToMove();
+}
+
+template <class G>
+void BasicBoard<G>::print() const {
+	const int width = int(std::to_string(G::SIZE).size());	//of the row labels
+	const std::string border = std::string(width + 1, ' ') + "+ " + std::string(2 * G::SIZE - 1, '-') + " +";
+	std::cout << border << std::endl;
+	for (int i = G::SIZE - 1; i >= 0; --i) {	//reverse order so row 1 prints last
+		std::cout << std::setw(width) << i + (FIRST_ROW - '0') << " | ";	//row label
+		for (int j = 0; j < G::SIZE; ++j) {
 			//can substitute with m_neverMoved to check if initial moves are allowed when appropriate
-			std::cout << m_board[i][j];
-			if (j == BOARD_SIZE - 1)
+			std::cout << m_board[G::makeSquare(i, j)];
+			if (j == G::SIZE - 1)
 				std::cout << " |" << std::endl;
 			else
 				std::cout << ' ';
 		}
 	}
-	std::cout << "  + --------------- +" << std::endl << "    ";	//col label
-	for (char c = 0; c < BOARD_SIZE; ++c) {
+	std::cout << border << std::endl << std::string(width + 3, ' ');	//col label
+	for (char c = 0; c < G::SIZE; ++c) {
 		std::cout << char(c + FIRST_COL);
-		if (c == BOARD_SIZE - 1)
+		if (c == G::SIZE - 1)
 			std::cout << std::endl;
 		else
 			std::cout << ' ';
 	}
 }
 
-void Board::freeze() {
-	std::copy(&m_board[0][0], &m_board[0][0] + BOARD_SIZE * BOARD_SIZE, &m_board_backup[0][0]);
-	std::copy(&m_neverMoved[0][0], &m_neverMoved[0][0] + BOARD_SIZE * BOARD_SIZE, &m_neverMoved_backup[0][0]);
-}
-
-void Board::unfreeze() {
-	std::copy(&m_board_backup[0][0], &m_board_backup[0][0] + BOARD_SIZE * BOARD_SIZE, &m_board[0][0]);
-	std::copy(&m_neverMoved_backup[0][0], &m_neverMoved_backup[0][0] + BOARD_SIZE * BOARD_SIZE, &m_neverMoved[0][0]);
-}
-
 // Private
 // -------
-const char& Board::pieceAt(const std::string& pos) const {
-	return m_board[pos[1] - FIRST_ROW][pos[0] - FIRST_COL];
-}
-
-void Board::setPiece(const std::string& pos, const char& replacement) {
-	m_board[pos[1] - FIRST_ROW][pos[0] - FIRST_COL] = replacement;
-}
-
-const bool& Board::neverMovedAt(const std::string& pos) const {
-	return m_neverMoved[pos[1] - FIRST_ROW][pos[0] - FIRST_COL];
+template <class G>
+void BasicBoard<G>::place(const Snapshot& snapshot) {
+	m_sides[WHITE] = m_sides[BLACK] = 0;
+	m_pieces.assign(m_plib->size(), Bitboard(0));
+	m_royal[WHITE] = m_royal[BLACK] = NO_SQUARE;
+	m_neverMoved = 0;
+	m_turn = snapshot.turn;
+	m_hash = (m_turn == BLACK) ? m_zobrist->blackToMove() : 0;
+	for (Square sq = 0; sq < SQUARES; ++sq) {
+		m_board[sq] = EMPTY;
+		setPiece(sq, snapshot.board[sq]);
+	}
+	for (Bitboard neverMoved = snapshot.neverMoved; neverMoved;) {	//after pieces, since their initial moves decide the hash
+		setNeverMovedAt(popLsb(neverMoved), true);
+	}
 }
 
-void Board::setNeverMovedAt(const std::string& pos, const bool& replacement) {
-	m_neverMoved[pos[1] - FIRST_ROW][pos[0] - FIRST_COL] = replacement;
+template <class G>
+void BasicBoard<G>::setPiece(const Square& pos, const char& replacement) {
+	m_hash ^= squareKey(pos);
+	if (m_board[pos] != EMPTY) {	//lift piece currently there
+		int side = whichSide(m_board[pos]);
+		m_sides[side] &= ~G::squareBit(pos);
+		m_pieces[m_plib->indexOf(m_board[pos])] &= ~G::squareBit(pos);
+		if (m_royal[side] == pos) {
+			m_royal[side] = NO_SQUARE;
+		}
+	}
+	m_board[pos] = replacement;
+	if (replacement != EMPTY) {
+		int side = whichSide(replacement);
+		m_sides[side] |= G::squareBit(pos);
+		m_pieces[m_plib->indexOf(replacement)] |= G::squareBit(pos);
+		if (replacement == m_royalPiece[side]) {
+			m_royal[side] = pos;
+		}
+	}
+	m_hash ^= squareKey(pos);
 }
 
-const std::string Board::offset(const std::string& pos, const std::vector<int>& offset, const int& side) const {
-	std::string result;
-	result += char(pos[0] + offset[1]);
-	if (side == WHITE)
-		result += char(pos[1] + offset[0]);
-	else if (side == BLACK)	//face opposite direction
-		result += char(pos[1] - offset[0]);
-	return result;
+template <class G>
+bool BasicBoard<G>::neverMovedAt(const Square& pos) const {
+	return (m_neverMoved & G::squareBit(pos)) != 0;
 }
 
-bool Board::onBoard(const std::string& pos) const {
-	return (pos.size() == 2 &&
-		pos[0] >= FIRST_COL && pos[0] < char(FIRST_COL + BOARD_SIZE) &&
-		pos[1] >= FIRST_ROW && pos[1] < char(FIRST_ROW + BOARD_SIZE));
+template <class G>
+void BasicBoard<G>::setNeverMovedAt(const Square& pos, const bool& replacement) {
+	m_hash ^= squareKey(pos);
+	if (replacement) {
+		m_neverMoved |= G::squareBit(pos);
+	} else {
+		m_neverMoved &= ~G::squareBit(pos);
+	}
+	m_hash ^= squareKey(pos);
 }
 
-const std::string Board::findRoyal(const int& side) const {
-	for (char row = FIRST_ROW; row < char(FIRST_ROW + BOARD_SIZE); ++row) {
-		for (char col = FIRST_COL; col < char(FIRST_COL + BOARD_SIZE); ++col) {
-			std::string pos;
-			pos += col;
-			pos += row;
-			if (pieceAt(pos) == m_rules.getRoyal(side)) {
-				return pos;
-			}
-		}
+template <class G>
+uint64_t BasicBoard<G>::squareKey(const Square& pos) const {
+	if (isEmpty(pos)) {
+		return 0;
+	}
+	uint64_t key = m_zobrist->piece(m_plib->indexOf(pieceAt(pos)), whichSide(pieceAt(pos)), pos);
+	if (neverMovedAt(pos) && !m_plib->getOffsets(pieceAt(pos), OFFSET_INITIAL).empty()) {	//only matters if it enables initial moves
+		key ^= m_zobrist->neverMoved(pos);
 	}
-	return std::string();
+	return key;
 }
 
-bool Board::acceptAll(const std::string & dummy1, const std::string & dummy2) const {
-	return true;
+template <class G>
+typename BasicBoard<G>::Bitboard BasicBoard<G>::occupied() const {
+	return m_sides[WHITE] | m_sides[BLACK];
 }
 
-bool Board::rejectAll(const std::string & dummy1, const std::string & dummy2) const {
-	return false;
+template <class G>
+Square BasicBoard<G>::findRoyal(const int& side) const {
+	return m_royal[side];
 }
 
-bool Board::isEmpty(const std::string& pos, const std::string& dummy) const {
+template <class G>
+bool BasicBoard<G>::isEmpty(const Square& pos) const {
 	return pieceAt(pos) == EMPTY;
 }
 
-bool Board::isEnemy(const std::string& otherPos, const std::string& pos) const {
-	return ((pieceAt(otherPos) != EMPTY) && (whichSide(pieceAt(otherPos)) != whichSide(pieceAt(pos))));
+template <class G>
+typename BasicBoard<G>::Bitboard BasicBoard<G>::attackersOf(const Square& target, const int& bySide) const {
+	Bitboard occ = occupied();
+	Bitboard attackers = 0;
+	for (int piece = 0; piece < m_plib->size(); ++piece) {
+		Bitboard candidates = m_pieces[piece] & m_sides[bySide];
+		if (candidates) {
+			attackers |= m_attacks->attackers(piece, bySide, target, occ) & candidates;
+		}
+	}
+	return attackers;
 }
 
-bool Board::isFriendly(const std::string & otherPos, const std::string & pos) const {
-	return ((pieceAt(otherPos) != EMPTY) && (whichSide(pieceAt(otherPos)) == whichSide(pieceAt(pos))));
+template <class G>
+typename BasicBoard<G>::Bitboard BasicBoard<G>::listFuture(const Square& current, const OffsetKind& kind) const {
+	return m_attacks->attacks(kind, m_plib->indexOf(pieceAt(current)), whichSide(pieceAt(current)), current, occupied());
 }
 
-std::vector<std::string> Board::listFuture(const std::string& current, const std::string& offsetKey,
-	restrictionFxn reqf, restrictionFxn passf, const int& maxReq) {
-	std::vector<std::string> future;
-
-	// Identify piece char from json
-	std::vector<std::vector<int>> offsets;
-	if (!m_plib.contains(pieceAt(current))) {
-		throw std::invalid_argument("Unidentified piece on the board. No available moves.");
-	} else {
-		offsets = m_plib.getOffsets(pieceAt(current), offsetKey);
+template <class G>
+typename BasicBoard<G>::Bitboard BasicBoard<G>::moveTargets(const Square& current) const {
+	//moves can only land on empty positions; a ray stops before the first piece it meets
+	Bitboard moves = listFuture(current, OFFSET_MOVE);
+	if (neverMovedAt(current)) {	//add any additional initial moves
+		moves |= listFuture(current, OFFSET_INITIAL);
 	}
+	return moves & ~occupied();
+}
 
-	// Calculate offsets
-	int side = whichSide(pieceAt(current));
-	for (auto& o : offsets) {
-		for (std::string next = offset(current, o, side); onBoard(next); next = offset(next, o, side)) {
-			if (future.size() >= maxReq) {
-				break;
-			}
-			//next meets restriction and belongs to future (member function pointer syntax)
-			else if ((this->*reqf)(next, current)) {
-				future.push_back(next);
-			}
-			//next isn't an allowable intermediate position
-			else if (!(this->*passf)(next, current)) {
-				break;
-			}
-			//single offset - no more chances
-			if (o.size() == JSON_RANGE_INDEX) {	
-				break;
-			}
-		}
-	}
-	return future;
+template <class G>
+typename BasicBoard<G>::Bitboard BasicBoard<G>::captureTargets(const Square& current) const {
+	//only the first piece along a ray can be captured, and only if it is an enemy
+	return listFuture(current, OFFSET_CAPTURE) & m_sides[!whichSide(pieceAt(current))];
 }
 
-bool Board::isLegal(const std::string& current, const std::string& future, listFxn lf) {
-	for (std::string move : (this->*lf)(current)) {
-		if (future == move) {
-			if (wouldBeCheck(current, future)) {
-				throw std::invalid_argument("Move would put " + m_plib.getName(pieceAt(findRoyal(whichSide(pieceAt(current)))))
-					+ " in check. Try again.");
-			} else {
-				return true;
-			}
-		}
+template <class G>
+MoveStatus BasicBoard<G>::legality(const Square& current, const Square& future) noexcept {
+	if (!((moveTargets(current) | captureTargets(current)) & G::squareBit(future))) {	//must fail both move and capture
+		return MOVE_ILLEGAL;
 	}
-	return false;
+	return wouldBeCheck(current, future) ? MOVE_INTO_CHECK : MOVE_OK;
 }
 
-void Board::execMove(const std::string & current, const std::string & future) {
-	setPiece(future, pieceAt(current));
-	setPiece(current, EMPTY);
-	setNeverMovedAt(current, false);	//no initial move can be made from current or future now
-	setNeverMovedAt(future, false);
-}
+// Instantiations
+// --------------
+template class BasicBoard<Geometry<8>>;
+template class BasicBoard<Geometry<10>>;
+template class BasicBoard<Geometry<12>>;
@@ -1,64 +1,171 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include "piece_library.h"
-#include "ruleset.h"
+#include "rules_registry.h"
 #include "constants.h"
+#include "square.h"
+#include "bitboard.h"
+#include "move.h"
+#include "zobrist.h"
+
+
+/*
+	@brief		board of geometry G; the game, search and saves use Board (BOARD_SIZE x BOARD_SIZE), while perft can also
+				set up rules for the other sizes of isBoardSize
+*/
+template <class G>
+class BasicBoard {
+public:
+	/*
+		@brief		set of squares of the board, one bit per Square
+	*/
+	typedef typename G::Mask Bitboard;
 
+	static constexpr int SQUARES = G::SQUARES;
 
-class Board {
-public:
 	/*
-		@brief		calls reset()
+		@brief		points at the rules registry of the process for G (see RulesRegistry), selects rules, and calls reset()
+
+		@param		rules		name of rules object in ruleset.json, for a board of geometry G
+
+		@throw		invalid_argument if rules can't be used
 	*/
-	Board();
+	explicit BasicBoard(const std::string& rules = DEFAULT_RULES);
 
 	/*
 		@brief		replaces current state of m_board with m_initial_name from initial_board.json
-					all PieceLib public functions are const, so no need to reset m_plib; similarly for Ruleset
+					the rules registry is immutable and shared, so only the selected rules can change
 					
 
 		@param		newRules		if supplied, rules will be updated as well
+
+		@throw		invalid_argument if newRules don't exist or can't be used, e.g. are for a board of another size
+					(the board and its rules are unchanged)
 	*/
 	void reset(const std::string& newRules = "");
 
 	/*
-		@brief		calls printAll from m_rules
+		@brief		compact copy of a position: enough to restore it exactly with the same rules
+	*/
+	struct Snapshot {
+		char board[SQUARES];
+		Bitboard neverMoved;
+		int turn;
+		uint64_t hash;		//checksum: Zobrist hash of the position the snapshot was taken from
+	};
+
+	/*
+		@return		snapshot of the current position
+	*/
+	Snapshot snapshot() const;
+
+	/*
+		@brief		sets the board to a snapshot taken under the current rules
+
+		@param		snapshot	position to restore
+
+		@return		true if restored; false (and the board is reset) if the snapshot holds unknown pieces
+					or its hash doesn't match the position it describes
+	*/
+	bool restore(const Snapshot& snapshot);
+
+	/*
+		@brief		prints the name of every rules object Board can be reset to
 	*/
 	void printRules();
 
 	/*
-		@param		current		position of piece before moving
+		@return		names of every rules object Board can be reset to
+	*/
+	std::vector<std::string> listRules() const;
+
+	/*
+		@param		side		enum of White or Black
+
+		@return		every position containing a piece belonging to side
+	*/
+	Bitboard piecesOf(const int& side) const;
+
+	/*
+		@return		library of the pieces the board can hold
+	*/
+	const PieceLibrary& pieces() const;
+
+	/*
+		@return		attack masks of the pieces the board can hold
+	*/
+	const BasicAttackTable<G>& attacks() const;
+
+	/*
+		@param		pos			position of a piece
+
+		@return		char of piece at pos, cannot be modified: check constants.h
+	*/
+	const char& pieceAt(const Square& pos) const;
+
+	/*
+		@return		enum of side to move; flipped by every makeMove and unmakeMove
+	*/
+	int turn() const;
+
+	/*
+		@return		Zobrist hash of pieces on squares, side to move, and never-moved pieces that still have initial moves
+					kept up to date incrementally by reset, makeMove and unmakeMove
+	*/
+	uint64_t hash() const;
+
+	/*
+		@param		current		position of piece before moving (NO_SQUARE if it could not be parsed)
 		@param		turn		current turn
 
-		@throw		std::invalid_argument
+		@return		MOVE_OK, MOVE_CURRENT_OFF_BOARD, MOVE_EMPTY_SQUARE or MOVE_WRONG_SIDE
 	*/
-	void validateCurrent(const std::string& current, const int& turn) const;
+	MoveStatus checkCurrent(const Square& current, const int& turn) const noexcept;
 
 	/*
-		@param		future		position of piece after moving
+		@param		future		position of piece after moving (NO_SQUARE if it could not be parsed)
+
+		@return		MOVE_OK or MOVE_FUTURE_OFF_BOARD
+	*/
+	MoveStatus checkFuture(const Square& future) const noexcept;
+
+	/*
+		@param		current		position of piece before moving (NO_SQUARE if it could not be parsed)
 		@param		turn		current turn
 
-		@throw		std::invalid_argument
+		@throw		std::invalid_argument with the message of checkCurrent's status
 	*/
-	void validateFuture(const std::string& future, const int& turn) const;
+	void validateCurrent(const Square& current, const int& turn) const;
 
+	/*
+		@param		future		position of piece after moving (NO_SQUARE if it could not be parsed)
+		@param		turn		current turn
 
-	typedef std::vector<std::string>(Board::*listFxn)(const std::string&);
+		@throw		std::invalid_argument with the message of checkFuture's status
+	*/
+	void validateFuture(const Square& future, const int& turn) const;
+
+	/*
+		@param		status		anything but MOVE_OK, returned for a move from current
+		@param		current		position of piece before moving
+
+		@return		message the console shows for status (call before the board changes)
+	*/
+	std::string describe(const MoveStatus& status, const Square& current) const;
 
 	/*
 		@param		current		position of piece before moving
 
 		@return		vector of legal positions that piece at current could move to (may include initial moves; without capturing)
 	*/
-	std::vector<std::string> listMoves(const std::string& current);
+	std::vector<Square> listMoves(const Square& current);
 
 	/*
 		@param		current		position of piece before capturing
 
 		@return		vector of legal positions that piece at current could capture
 	*/
-	std::vector<std::string> listCaptures(const std::string& current);
+	std::vector<Square> listCaptures(const Square& current);
 	
 	/*
 		@param		side		which side should be "checked" for check?
@@ -67,13 +174,30 @@ public:
 	*/
 	bool inCheck(const int& side);
 
+	/*
+		@param		target		position that may be attacked
+		@param		bySide		side whose pieces may be attacking target
+
+		@return		true if any piece of bySide could capture a piece standing on target
+	*/
+	bool isSquareAttacked(const Square& target, const int& bySide) const;
+
 	/*
 		@param		current		position of piece before moving
 		@param		future		position of piece after moving
 
 		@return		true if royal piece would be in check, had this move been executed
 	*/
-	bool wouldBeCheck(const std::string& current, const std::string& future);
+	bool wouldBeCheck(const Square& current, const Square& future);
+
+	/*
+		@param		side		side to generate moves for
+
+		@return		every legal move and capture of side, in a single pass over its pieces
+					pins and checks are worked out up front from the royal position, so only royal moves, possible blocks
+					of a check, and captures of a checker when there are several have to be made and tested
+	*/
+	std::vector<Move> generateLegalMoves(const int& side);
 
 	/*
 		@param		side		which side is potentially in checkmate?
@@ -86,196 +210,226 @@ public:
 		@brief		preliminary test for checkmate, check, and announcing whose turn it is
 
 		@param		side		whose turn is it?
+		@param		legal		legal moves of side from generateLegalMoves (checkmate if empty)
 
 		@return		true if any move can be made (board not in checkmate)
 	*/
-	bool preMove(const int& side);
+	bool preMove(const int& side, const std::vector<Move>& legal);
+
+	/*
+		@brief		everything needed to take back a move made with makeMove
+	*/
+	struct Undo {
+		Square current;
+		Square future;
+		char captured;				//piece that stood on future (EMPTY if the move was not a capture)
+		bool currentNeverMoved;		//neverMoved bits of current and future before the move
+		bool futureNeverMoved;
+	};
 
 	/*
 		@param		current		position of piece before moving
 		@param		future		position of piece after moving
 		@param		silent		if true, won't print description of what move occurred
+		@param		undo		if not null, receives the record that takes the move back
 
 		@return		true if move is completed, false if turn continues
 
 		@throw		std::invalid_argument
 	*/
-	bool attemptMove(const std::string& current, const std::string& future, const bool& silent = false);
+	bool attemptMove(const Square& current, const Square& future, const bool& silent = false, Undo* undo = nullptr);
 
 	/*
-		@brief		prints layout of board to standard output
+		@brief		checks and silently plays a move, without throwing or allocating; the counterpart of
+					validateCurrent, validateFuture and attemptMove for bulk validation and servers
+
+		@param		current		position of piece before moving (NO_SQUARE if it could not be parsed)
+		@param		future		position of piece after moving (NO_SQUARE if it could not be parsed)
+		@param		turn		current turn
+		@param		undo		if not null and the move is played, receives the record that takes the move back
+
+		@return		MOVE_OK if the move was played, otherwise why not (the board is unchanged)
 	*/
-	void print() const;
+	MoveStatus tryMove(const Square& current, const Square& future, const int& turn, Undo* undo = nullptr) noexcept;
 
-private:
 	/*
-		@brief		makes backups of board and neverMoved so that what if checks can be carried out non-destructively
+		@brief		changes char's in board and neverMoved and passes the turn (DOES NOT CHECK FOR MOVE VALIDITY)
+
+		@param		current		position of piece
+		@param		future		possible position of piece
+
+		@return		record that unmakeMove uses to restore the board exactly
 	*/
-	void freeze();
+	Undo makeMove(const Square& current, const Square& future);
 
 	/*
-		@brief		restores backups of board and neverMoved
-		MAKE SURE UNFREEZE WILL BE CALLED BEFORE AN EARLY RETURN!!!!!!!!!!!!!!
+		@brief		takes back a move; moves must be unmade in the reverse order they were made
+
+		@param		undo		record returned by makeMove
 	*/
-	void unfreeze();
+	void unmakeMove(const Undo& undo);
 
 	/*
-		@param		pos			position of a piece
-
-		@return		char of piece at pos, cannot be modified: check constants.h
+		@brief		prints layout of board to standard output
 	*/
-	const char& pieceAt(const std::string& pos) const;
+	void print() const;
 
+private:
 	/*
 		@param		pos			position of a piece
 		@param		replacement	new char of piece
 	*/
-	void setPiece(const std::string& pos, const char& replacement);
+	void setPiece(const Square& pos, const char& replacement);
 
 	/*
-		@param		pos			position
+		@brief		replaces the position with snapshot, recomputing occupancy, royal positions and hash (ignores snapshot.hash)
 
-		@return		bool of pos according to m_neverMoved, cannot be modified
+		@param		snapshot	position to set up; every piece must be in m_plib
 	*/
-	const bool& neverMovedAt(const std::string& pos) const;
+	void place(const Snapshot& snapshot);
 
 	/*
 		@param		pos			position
-		@param		replacement	new bool at pos
-	*/
-	void setNeverMovedAt(const std::string& pos, const bool& replacement);
 
-	/*
-		@param		pos			position (in algebraic notation) to offset from
-		@param		offset		[offset in forward direction (negative is backwards), offset in right direction (negative is left)]
-		@param		side		enum of White or Black; must be supplied for calls in listFuture (moves are planned where the piece is not located yet)
-
-		@return		a new position offset from pos, according to side of piece at pos
+		@return		bool of pos according to m_neverMoved
 	*/
-	const std::string offset(const std::string& pos, const std::vector<int>& offset, const int& side) const;
+	bool neverMovedAt(const Square& pos) const;
 
 	/*
-		@param		pos			position in question
-
-		@return		true if pos is contained within the board dimensions, false otherwise
+		@param		pos			position
+		@param		replacement	new bool at pos
 	*/
-	bool onBoard(const std::string& pos) const;
+	void setNeverMovedAt(const Square& pos, const bool& replacement);
 
 	/*
-		@param		side		side whose royal piece must be found
+		@param		pos			position
 
-		@return		position of royal piece belonging to side of side
+		@return		XOR of the Zobrist keys of whatever is on pos (0 if empty)
 	*/
-	const std::string findRoyal(const int& side) const;
-
-	typedef bool (Board::*restrictionFxn)(const std::string&, const std::string&) const;
+	uint64_t squareKey(const Square& pos) const;
 
 	/*
-		@param		dummy		dummy argument to fit restrictionFxn typedef; see listFuture
-		@param		dummy		dummy argument to fit restrictionFxn typedef; see listFuture
-
-		@return		true always
+		@return		every square containing a piece of either side
 	*/
-	bool acceptAll(const std::string& dummy1 = "", const std::string& dummy2 = "") const;
+	Bitboard occupied() const;
 
 	/*
-		@param		dummy		dummy argument to fit restrictionFxn typedef; see listFuture
-		@param		dummy		dummy argument to fit restrictionFxn typedef; see listFuture
+		@param		side		side whose royal piece must be found
 
-		@return		false always
+		@return		position of royal piece belonging to side of side, NO_SQUARE if there is none
+					tracked by setPiece, so no search is needed
 	*/
-	bool rejectAll(const std::string& dummy1 = "", const std::string& dummy2 = "") const;
+	Square findRoyal(const int& side) const;
 
 	/*
 		@param		pos			position in question
-		@param		dummy		dummy argument to fit restrictionFxn typedef; see listFuture
 
 		@return		true if pos is the empty char, false otherwise
 	*/
-	bool isEmpty(const std::string& pos, const std::string& dummy = "") const;
+	bool isEmpty(const Square& pos) const;
 
 	/*
-		@param		otherPos		position of potential enemy
-		@param		pos				position where 'enemy' is determined from
+		@param		target		position that may be attacked
+		@param		bySide		side whose pieces may be attacking target
 
-		@return		true if otherPos contains a piece belonging to side other than myPos, false otherwise
+		@return		every position holding a piece of bySide that could capture a piece standing on target
 	*/
-	bool isEnemy(const std::string& otherPos, const std::string& pos) const;
+	Bitboard attackersOf(const Square& target, const int& bySide) const;
 
 	/*
-		@param		otherPos		position of potential enemy
-		@param		pos				position where 'enemy' is determined from
+		@brief		generic function that listMoves and listCaptures are built off of:
+					every ray of the piece stops at (and includes) the first occupied position
 
-		@return		true if otherPos contains a piece belonging to your side, false otherwise
-	*/
-	bool isFriendly(const std::string& otherPos, const std::string& pos) const;
 
-	/*
-		@brief		generic function that listMoves and listCaptures are built off of: restricted by offsetKey, reqf, passf, and maxReq
+		@param		current		position of piece
+		@param		kind		type of offsets to retrieve from AttackTable
 
+		@return		set of positions the piece at current reaches with offsets of type kind
+	*/
+	Bitboard listFuture(const Square& current, const OffsetKind& kind) const;
 
+	/*
 		@param		current		position of piece
-		@param		offsetKey	string of key in json to retrieve offsets array from
-		@param		reqf		function that all positions returned are required to obey
-		@param		passf		function that intermediate positions can pass instead of reqf (but won't be added to return)
-		@param		maxReq		maximum number of reqf-satisfying positions that can be returned
 
-		@return		vector of legal positions that piece at current could move to
-		
-		@throw		std::invalid_argument if piece at current if not found in PieceLibrary
+		@return		set of empty positions the piece at current could move to (including initial moves)
 	*/
-	std::vector<std::string> listFuture(const std::string& current, const std::string& offsetKey,
-		restrictionFxn reqf, restrictionFxn passf, const int& maxReq);
+	Bitboard moveTargets(const Square& current) const;
 
 	/*
 		@param		current		position of piece
-		@param		future		possible position of piece
-		@param		legalf		function that returns a legal list to check future against
 
-		@return		true if move is legal, false if not
+		@return		set of enemy positions the piece at current could capture
 	*/
-	bool isLegal(const std::string& current, const std::string& future, listFxn legalf);
+	Bitboard captureTargets(const Square& current) const;
 
 	/*
-		@brief		changes char's in board and neverMoved (DOES NOT CHECK FOR MOVE VALIDITY)
-
 		@param		current		position of piece
 		@param		future		possible position of piece
 
+		@return		MOVE_OK, MOVE_ILLEGAL if the piece cannot reach future, or MOVE_INTO_CHECK
 	*/
-	void execMove(const std::string& current, const std::string& future);
+	MoveStatus legality(const Square& current, const Square& future) noexcept;
 
 	// Member variables
 	// ----------------
 	/*
 		@brief		array of pieces currently in play using abbreviations from pieces.json
 	*/
-	char m_board[BOARD_SIZE][BOARD_SIZE];
+	char m_board[SQUARES];
 
 	/*
-		@brief		backup copy of board (so board can be modified for check tests)
+		@brief		occupancy of each side, indexed by White or Black
 	*/
-	char m_board_backup[BOARD_SIZE][BOARD_SIZE];
+	Bitboard m_sides[2];
 
 	/*
-		@brief		array of positions where a move has never been played from/to
+		@brief		occupancy of each piece type (both sides), indexed by PieceLibrary::indexOf
 	*/
-	bool m_neverMoved[BOARD_SIZE][BOARD_SIZE];
+	std::vector<Bitboard> m_pieces;
 
 	/*
-		@brief		backup copy of neverMoved (so neverMoved can be modeified for check tests)
+		@brief		position of each side's royal piece (NO_SQUARE if captured or absent), indexed by White or Black
 	*/
-	bool m_neverMoved_backup[BOARD_SIZE][BOARD_SIZE];
+	Square m_royal[2];
 
 	/*
-		@brief		library of piece rules
+		@brief		char of each side's royal piece, cached from m_rules on reset
 	*/
-	PieceLibrary m_plib;
+	char m_royalPiece[2];
 
 	/*
-		@brief		rules for initial board and royal piece
+		@brief		positions where a move has never been played from/to
 	*/
-	Ruleset m_rules;
+	Bitboard m_neverMoved;
+
+	/*
+		@brief		enum of side to move
+	*/
+	int m_turn;
+
+	/*
+		@brief		Zobrist hash of the current position
+	*/
+	uint64_t m_hash;
+
+	/*
+		@brief		rules files compiled once per process and shared with every other board, so copying a board is cheap
+	*/
+	std::shared_ptr<const BasicRulesRegistry<G>> m_registry;
+
+	/*
+		@brief		library of piece rules, attack masks and hash keys from m_registry (pointed to directly, as every move uses them)
+	*/
+	const PieceLibrary* m_plib;
+	const BasicAttackTable<G>* m_attacks;
+	const BasicZobrist<G>* m_zobrist;
+
+	/*
+		@brief		rules for initial board and royal piece, selected from m_registry
+	*/
+	const CompiledRules* m_rules;
 };
 
+typedef BasicBoard<BoardGeometry> Board;
+
 #endif BOARD_H
@@ -27,8 +27,28 @@ const std::string SAVE_ROUND = "round";
 const std::string SAVE_WHITE_TURN = "white_turn";
 const std::string SAVE_BLACK_TURN = "black_turn";
 const std::string SAVE_TIME = "time";
+const std::string SAVE_CHECKPOINTS = "checkpoints";
+const std::string SAVE_CHECKSUM = "checksum";
 
-const std::string UNDO_TEMP = "undo_temp";
+const std::string CHECKPOINT_MOVE = "move";				//number of moves played before the snapshot
+const std::string CHECKPOINT_BOARD = "board";			//one char per square, row by row from the first row
+const std::string CHECKPOINT_NEVER_MOVED = "never_moved";	//hex bitboard
+const std::string CHECKPOINT_TURN = "turn";
+const std::string CHECKPOINT_HASH = "hash";				//hex Zobrist hash of the position
+const int CHECKPOINT_INTERVAL = 16;						//default number of moves between checkpoints
+
+const std::string RECORD_EXT = ".ccg";		//binary game records (see GameRecord)
+const std::string RECORD_MAGIC = "CCGR";
+const std::string CONVERT = "convert";		//name of the headless JSON/record converter
+
+const std::string DATABASE = "db";			//name of the headless game database tool, and its subcommands (see GameDatabase)
+const std::string DATABASE_MAGIC = "CCDB";
+const std::string DATABASE_EXT = ".ccdb";
+const std::string DATABASE_ADD = "add";
+const std::string DATABASE_INFO = "info";
+const std::string DATABASE_VALIDATE = "validate";
+const std::string DATABASE_EXPORT = "export";
+const size_t DATABASE_BLOCK = 64;			//games handed to a thread at a time by GameDatabase::forEach
 
 const std::string RULES_DIR = "rules\\";
 const std::string RULESET = "ruleset";
@@ -36,6 +56,58 @@ const std::string DEFAULT_RULES = "normal";
 const std::string RULES_BOARD = "board";
 const std::string RULES_ROYAL = "royal";
 
+const std::string PERFT = "perft";		//reference counts in RULES_DIR, and name of the headless perft command
+const std::string PERFT_ALL = "all";
+const std::string SMP = "smp";			//name of the headless parallel search benchmark
+const int SMP_DEPTH = 7;
+
+const std::string VALIDATE = "validate";				//name of the headless batch validator, and its report keys
+const std::string VALIDATE_REPORT = "validation_report";
+const std::string VALIDATE_DIRECTORY = "directory";
+const std::string VALIDATE_THREADS = "threads";
+const std::string VALIDATE_SECONDS = "seconds";
+const std::string VALIDATE_INVALID = "invalid";
+const std::string VALIDATE_FILES = "files";
+const std::string VALIDATE_FILE = "file";
+const std::string VALIDATE_VALID = "valid";
+const std::string VALIDATE_BAD_MOVE = "first_bad_move";
+const std::string VALIDATE_REASON = "reason";
+
+const std::string ENGINE = "engine";		//name of the headless text protocol (see Protocol), and its commands
+const std::string ENGINE_UCI = "uci";
+const std::string ENGINE_ISREADY = "isready";
+const std::string ENGINE_NEWGAME = "newgame";
+const std::string ENGINE_POSITION = "position";
+const std::string ENGINE_MOVES = "moves";
+const std::string ENGINE_GO = "go";
+const std::string ENGINE_MOVETIME = "movetime";
+const std::string ENGINE_DEPTH = "depth";
+const std::string ENGINE_PERFT = "perft";
+const std::string ENGINE_BENCH = "bench";
+const std::string ENGINE_QUIT = "quit";
+const int BENCH_PERFT_DEPTH = 4;			//depths every ruleset is counted and searched to by the bench command
+const int BENCH_SEARCH_DEPTH = 5;
+
+const std::string SERVER = "server";		//name of the headless game server (see Server), and its requests
+const std::string SERVER_BENCH = "bench";
+const std::string SERVER_NEW = "new";
+const std::string SERVER_MOVE = "move";
+const std::string SERVER_LEGAL = "legal";
+const std::string SERVER_UNDO = "undo";
+const std::string SERVER_HISTORY = "history";
+const std::string SERVER_CLOSE = "close";
+const std::string SERVER_STATS = "stats";
+const int SERVER_PORT = 7420;
+const size_t SERVER_MAX_FRAME = 1 << 16;	//longest request or reply; a connection sending a longer one is closed
+const size_t SERVER_MAX_SESSIONS = 1024;	//sessions one connection may hold at once
+const int SERVER_POLL_MILLISECONDS = 100;	//how often idle workers check whether the server is stopping
+
+const std::string OPTION_HASH = "--hash";				//startup options: transposition table size in MB,
+const std::string OPTION_HUGE_PAGES = "--huge-pages";	//and whether to back it with huge pages
+const std::string OPTION_THREADS = "--threads";		//number of threads computer moves are searched with
+const std::string OPTION_CHECKPOINTS = "--checkpoints";	//moves between checkpoints in saves (0 for none)
+const std::string OPTION_TRUSTED = "--trusted";			//skip legality checks when loading saves with a matching checksum
+
 const std::string PIECES_LIBRARY = "piece_library";
 const std::string PIECE_NAME = "name";
 const std::string PIECE_INITIAL_ARRAY = "initial";
@@ -46,7 +118,8 @@ const int JSON_RANGE_INDEX = 2;		//see note_on_pieces_json.txt
 const int JSON_RANGE_INFINITE = -1;
 
 
-const int BOARD_SIZE = 8;
+const int BOARD_SIZE = 8;			//size of the board the game, search and saves use (see isBoardSize for the others)
+const int MAX_BOARD_SIZE = 12;		//size of the largest board rules can be written for
 const char FIRST_ROW = '1';
 const char FIRST_COL = 'a';
 const char EMPTY = ' ';
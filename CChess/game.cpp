@@ -1,10 +1,15 @@
 #include <iostream>		// std::cout
 #include <fstream>		// std::ofstream
+#include <sstream>		// std::stringstream
+#include <algorithm>	// std::copy, std::sort
 
 #include "game.h"
+#include "parallel_search.h"
+#include "game_database.h"
 
 
-Game::Game() {
+Game::Game(const size_t& hashMegabytes, const bool& hugePages, const int& threads, const int& checkpointInterval, const bool& trusted)
+	: m_checkpointInterval(checkpointInterval), m_trusted(trusted), m_tt(hashMegabytes, hugePages), m_threads(threads) {
 	reset();
 }
 
@@ -29,7 +34,7 @@ void Game::play() {
 	bool playing = false;	//there are commands other than move available after checkmate
 	while (!playing) {
 		m_board.print();
-		std::cout << std::endl << "[m]ove  [h]istory  [s]ave  [l]oad  [u]ndo  [r]eset  [q]uit" << std::endl;
+		std::cout << std::endl << "[m]ove  [c]omputer move  [h]istory  [s]ave  [l]oad  [j]ump  data[b]ase  [u]ndo  re[d]o  [r]eset  [q]uit" << std::endl;
 		while (1) {	//retry until valid command
 			try {
 				char cmd;
@@ -40,24 +45,50 @@ void Game::play() {
 				case 'm':
 					move();
 					break;
+				case 'c':
+					computerMove();
+					break;
 				case 'h':
 					m_history.print();
 					break;
 				case 's':
-					m_history.save(requestString("filename (no extension)"), m_rules_name);
+					m_history.save(requestString("filename (no extension)"), m_rules_name, false, checkpointsToJson());
 					break;
 				case 'l':
 					load(requestString("filename (no extension)"));
 					break;
+				case 'j': {	//load only the first moves of a save
+					std::string filename = requestString("filename (no extension)");
+					int moves;
+					try {
+						moves = std::stoi(requestString("number of moves"));
+					} catch (const std::exception&) {	//not a number, or out of range
+						throw std::invalid_argument("Number of moves must be a number. Try again.");
+					}
+					load(filename, false, moves);
+					break;
+				}
+				case 'b': {	//load a game from a database
+					std::string database = requestString("database (no extension)");
+					size_t n;
+					try {
+						n = std::stoul(requestString("game number"));
+					} catch (const std::exception&) {
+						throw std::invalid_argument("Game number must be a number. Try again.");
+					}
+					loadFromDatabase(database, n);
+					break;
+				}
 				case 'u':
-					if (m_history.erase(1)) {//only undo 1 move
-						m_history.save(UNDO_TEMP, m_rules_name, true);	//all silently
-						load(UNDO_TEMP, true);
-						m_history.deleteSave(UNDO_TEMP, true);
-					} else {
+					if (!undo()) {	//only undo 1 move
 						std::cout << "No moves to undo!" << std::endl;
 					}
 					break;
+				case 'd':
+					if (!redo()) {
+						std::cout << "No moves to redo!" << std::endl;
+					}
+					break;
 				case 'r':
 					if (confirm()) {
 						if (confirm("Change rules")) {
@@ -95,14 +126,15 @@ void Game::play() {
 }
 
 void Game::move() {
-	if (m_board.preMove(m_turn)) {	//a move can be made
+	std::vector<Move> legal = m_board.generateLegalMoves(m_turn);	//generated once for the whole turn
+	if (m_board.preMove(m_turn, legal)) {	//a move can be made
 		std::string current, future;
 		while (1) {	//retry current
 			try {
 				std::cout << std::endl << "Current:\t\t";
 				std::getline(std::cin, current);
-				m_board.validateCurrent(current, m_turn);
-				listAvailable(current);
+				m_board.validateCurrent(toSquare(current), m_turn);
+				listAvailable(toSquare(current), legal);
 				break;
 			} catch (const std::invalid_argument& e) {	//current invalid OR no moves or captures
 				std::cout << e.what() << std::endl;
@@ -112,20 +144,11 @@ void Game::move() {
 			try {
 				std::cout << std::endl << "Future:\t\t\t";
 				std::getline(std::cin, future);
-				m_board.validateFuture(future, m_turn);		//check if future is feasible
-				if (m_board.attemptMove(current, future)) {	//check if future is legal
-					//turn is over
-					if (m_turn == WHITE) {
-						m_history.recordMove(m_turn, current, future);	//record before m_turn changes
-						m_turn = BLACK;
-					} else if (m_turn == BLACK) {
-						m_history.recordMove(m_turn, current, future, true);	//both turns have finished - last move of turn
-						m_turn = WHITE;	//new round begins
-					}
-				} else {
-					//turn is not over and m_turn has not changed
-					m_history.recordMove(m_turn, current, future);
-				}
+				m_board.validateFuture(toSquare(future), m_turn);		//check if future is feasible
+				Board::Undo undo;
+				bool turnOver = m_board.attemptMove(toSquare(current), toSquare(future), false, &undo);	//check if future is legal
+				m_undone.clear();	//a new move replaces whatever was undone
+				recordMove(current, future, turnOver, undo);
 				break;
 			} catch (const std::invalid_argument& e) {	//future invalid OR illegal move
 				std::cout << e.what() << std::endl;
@@ -134,42 +157,147 @@ void Game::move() {
 	}
 }
 
-void Game::load(const std::string& filename, const bool& silent) {
+void Game::computerMove() {
+	std::vector<Move> legal = m_board.generateLegalMoves(m_turn);
+	if (m_board.preMove(m_turn, legal)) {	//a move can be made
+		std::string input = requestString("think time in ms (ENTER for " + std::to_string(Search::DEFAULT_MILLISECONDS) + ")");
+		int milliseconds = Search::DEFAULT_MILLISECONDS;
+		if (!input.empty()) {
+			try {
+				milliseconds = std::stoi(input);
+			} catch (const std::exception&) {	//not a number, or out of range
+				throw std::invalid_argument("Think time must be a number of milliseconds. Try again.");
+			}
+		}
+		SearchResult result = ParallelSearch(m_board, m_tt, m_threads).think(milliseconds);
+		Board::Undo undo;
+		bool turnOver = m_board.attemptMove(result.best.current, result.best.future, false, &undo);
+		m_undone.clear();
+		recordMove(toAlgebraic(result.best.current), toAlgebraic(result.best.future), turnOver, undo);
+		std::cout << "> Searched " << result.nodes << " positions to depth " << result.depth << " in " << int(result.seconds * 1000)
+			<< " ms (score " << result.score << ")" << std::endl;
+	}
+}
+
+bool Game::undo() {
+	if (m_played.empty() && !m_beforeCheckpoint.empty() && !replayBeforeCheckpoint()) {
+		return false;
+	}
+	if (m_played.empty()) {
+		return false;
+	}
+	Played last = m_played.back();
+	m_played.pop_back();
+	m_board.unmakeMove(last.undo);
+	m_history.erase(1);
+	m_turn = last.turn;
+	while (!m_checkpoints.empty() && m_checkpoints.back().move > m_history.moves()) {
+		m_checkpoints.pop_back();
+	}
+	m_undone.push_back(last);
+	std::cout << "> Took back " << last.current << '-' << last.future << std::endl;
+	return true;
+}
+
+bool Game::redo() {
+	if (m_undone.empty()) {
+		return false;
+	}
+	Played last = m_undone.back();
+	m_undone.pop_back();
+	recordMove(last.current, last.future, last.turnOver, m_board.makeMove(last.undo.current, last.undo.future));	//was legal when first played
+	std::cout << "> Played again " << last.current << '-' << last.future << std::endl;
+	return true;
+}
+
+void Game::load(const std::string& filename, const bool& silent, const int& upTo) {
 	std::string path = SAVE_DIR + filename + JSON_EXT;
 	std::ifstream ifs(path);
 	json file = json::parse(ifs);
 	reset(file[SAVE_RULES].get<std::string>());
-	//streamlined version of move()
-	try {
-		for (int i = 0; i < file[SAVE_ROUND].size(); ++i) {	//rounds
-			for (const auto& m : file[SAVE_ROUND][std::to_string(i)][SAVE_WHITE_TURN]) {	//moves
-				m_board.validateCurrent(m[0], m_turn);
-				m_board.validateFuture(m[1], m_turn);
-				if (m_board.attemptMove(m[0], m[1], true)) {	//always silent
-					m_history.recordMove(m_turn, m[0], m[1]);
-					m_turn = BLACK;
-				} else {
-					m_history.recordMove(m_turn, m[0], m[1]);
-				}
+	bool intact = (file.find(SAVE_CHECKSUM) != file.end() && file[SAVE_CHECKSUM] == History::checksum(file));
+	//moves in the order they were played, with the side that played them
+	std::vector<json> moves;
+	std::vector<int> sides;
+	for (int i = 0; i < file[SAVE_ROUND].size(); ++i) {	//rounds
+		for (const auto& m : file[SAVE_ROUND][std::to_string(i)][SAVE_WHITE_TURN]) {	//moves
+			moves.push_back(m);
+			sides.push_back(WHITE);
+		}
+		for (const auto& m : file[SAVE_ROUND][std::to_string(i)][SAVE_BLACK_TURN]) {
+			moves.push_back(m);
+			sides.push_back(BLACK);
+		}
+	}
+	int count = (upTo < 0 || upTo > int(moves.size())) ? int(moves.size()) : upTo;
+	int start = 0;
+	//restore the last checkpoint that isn't past count; the moves before it go straight into history
+	if (intact && file.find(SAVE_CHECKPOINTS) != file.end()) {
+		std::vector<Checkpoint> restored;
+		for (const json& c : file[SAVE_CHECKPOINTS]) {
+			Checkpoint checkpoint;
+			if (checkpointFromJson(c, int(moves.size()), checkpoint) && checkpoint.move <= count) {
+				restored.push_back(checkpoint);
 			}
-			for (const auto& m : file[SAVE_ROUND][std::to_string(i)][SAVE_BLACK_TURN]) {
-				m_board.validateCurrent(m[0], m_turn);
-				m_board.validateFuture(m[1], m_turn);
-				if (m_board.attemptMove(m[0], m[1], true)) {	//always silent
-					m_history.recordMove(m_turn, m[0], m[1], true);
-					m_turn = WHITE;
-				} else {
-					m_history.recordMove(m_turn, m[0], m[1]);
-				}
+		}
+		std::sort(restored.begin(), restored.end(), [](const Checkpoint& a, const Checkpoint& b) { return a.move < b.move; });	//in any order in the file
+		if (!restored.empty() && m_board.restore(restored.back().snapshot)) {
+			start = restored.back().move;
+			m_turn = restored.back().snapshot.turn;
+			m_checkpoints = restored;
+			for (int i = 0; i < start; ++i) {
+				bool last = (sides[i] == BLACK && (i + 1 == int(moves.size()) || sides[i + 1] == WHITE));	//Black ends the round
+				m_history.recordMove(sides[i], moves[i][0], moves[i][1], last);
+				m_beforeCheckpoint.push_back({ Board::Undo(), moves[i][0], moves[i][1], sides[i], true });
+			}
+		}
+	}
+	//streamlined version of move()
+	for (int i = start; i < count; ++i) {
+		Square current = toSquare(moves[i][0]), future = toSquare(moves[i][1]);
+		Board::Undo undo;
+		//the checksum only catches accidental edits, so even trusted moves must be of the side to move and on the board
+		if (m_trusted && intact && m_board.checkCurrent(current, m_turn) == MOVE_OK && m_board.checkFuture(future) == MOVE_OK) {
+			undo = m_board.makeMove(current, future);
+		} else {
+			MoveStatus status = m_board.tryMove(current, future, m_turn, &undo);	//always silent
+			if (status != MOVE_OK) {
+				std::cout << m_board.describe(status, current) << std::endl;
+				std::cout << path << " contains invalid move(s). Game will be reset." << std::endl;	//TODO:resotre to previous state using copy constructors
+				reset();
+				return;
 			}
 		}
-		if (!silent) {
-			std::cout << "Game successfully loaded from " << path << " (" << file[SAVE_TIME].get<std::string>() << ")" << std::endl;
+		recordMove(moves[i][0], moves[i][1], true, undo);
+	}
+	if (!silent) {
+		std::cout << "Game successfully loaded from " << path << " (" << file[SAVE_TIME].get<std::string>() << ")" << std::endl;
+		if (start > 0) {
+			std::cout << "Restored checkpoint at move " << start << ", replayed " << count - start << " move(s)" << std::endl;
+		}
+	}
+}
+
+void Game::loadFromDatabase(const std::string& database, const size_t& n, const bool& silent) {
+	std::string path = SAVE_DIR + database + DATABASE_EXT;
+	GameDatabase db(path);
+	GameRecordView game = db.game(n);
+	reset(std::string(game.rules));
+	for (uint32_t i = 0; i < game.count; ++i) {
+		uint16_t m = game.move(i);
+		Square current = GameRecord::current(m), future = GameRecord::future(m);
+		Board::Undo undo;
+		MoveStatus status = m_board.tryMove(current, future, m_turn, &undo);
+		if (status != MOVE_OK) {
+			std::cout << m_board.describe(status, current) << std::endl;
+			std::cout << "Game " << n << " of " << path << " contains invalid move(s). Game will be reset." << std::endl;
+			reset();
+			return;
 		}
-	} catch (const std::invalid_argument& e) {
-		std::cout << e.what() << std::endl;
-		std::cout << path << " contains invalid move(s). Game will be reset." << std::endl;	//TODO:resotre to previous state using copy constructors
-		reset();
+		recordMove(toAlgebraic(current), toAlgebraic(future), true, undo);
+	}
+	if (!silent) {
+		std::cout << "Game " << n << " successfully loaded from " << path << " (" << game.time << ")" << std::endl;
 	}
 }
 
@@ -180,6 +308,10 @@ void Game::reset(const std::string& newRules) {
 	m_board.reset(m_rules_name);	//still ok if empty
 	m_turn = FIRST_TURN;
 	m_history.reset();
+	m_played.clear();
+	m_undone.clear();
+	m_beforeCheckpoint.clear();
+	m_checkpoints.clear();
 }
 
 bool Game::confirm(const std::string& message) const {
@@ -197,19 +329,102 @@ const std::string Game::requestString(const std::string& message) const {
 	return filename;
 }
 
-void Game::listAvailable(const std::string & current) {
-	std::vector<std::string> moves = m_board.listMoves(current);
-	std::vector<std::string> captures = m_board.listCaptures(current);
+void Game::listAvailable(const Square& current, const std::vector<Move>& legal) {
+	std::vector<Square> moves, captures;
+	for (const Move& m : legal) {
+		if (m.current == current) {
+			((m.type == MOVE_CAPTURE) ? captures : moves).push_back(m.future);
+		}
+	}
 	if (moves.size() == 0 && captures.size() == 0) {
 		throw std::invalid_argument("No available moves or captures. Try again.");
 	}
 	std::cout << "Available moves:\t";
-	for (std::string m : moves) {
-		std::cout << m << ' ';
+	for (const Square& m : moves) {
+		std::cout << toAlgebraic(m) << ' ';
 	}
 	std::cout << std::endl << "Available captures:\t";
-	for (std::string c : captures) {
-		std::cout << c << ' ';
+	for (const Square& c : captures) {
+		std::cout << toAlgebraic(c) << ' ';
 	}
 	std::cout << std::endl;
 }
+
+void Game::recordMove(const std::string& current, const std::string& future, const bool& turnOver, const Board::Undo& undo) {
+	m_played.push_back({ undo, current, future, m_turn, turnOver });
+	if (turnOver) {
+		if (m_turn == WHITE) {
+			m_history.recordMove(m_turn, current, future);	//record before m_turn changes
+			m_turn = BLACK;
+		} else if (m_turn == BLACK) {
+			m_history.recordMove(m_turn, current, future, true);	//both turns have finished - last move of turn
+			m_turn = WHITE;	//new round begins
+		}
+	} else {
+		//turn is not over and m_turn has not changed
+		m_history.recordMove(m_turn, current, future);
+	}
+	if (m_checkpointInterval > 0 && m_history.moves() % m_checkpointInterval == 0) {
+		m_checkpoints.push_back({ m_history.moves(), m_board.snapshot() });
+	}
+}
+
+bool Game::replayBeforeCheckpoint() {
+	Board board = m_board;	//only replaces m_board if every move is legal
+	board.reset(m_rules_name);
+	std::vector<Played> played = m_beforeCheckpoint;
+	for (Played& p : played) {
+		MoveStatus status = board.tryMove(toSquare(p.current), toSquare(p.future), p.turn, &p.undo);
+		if (status != MOVE_OK) {
+			std::cout << board.describe(status, toSquare(p.current)) << std::endl
+				<< "Moves before the checkpoint cannot be taken back." << std::endl;
+			return false;
+		}
+	}
+	if (board.hash() != m_board.hash()) {	//the checkpoint wasn't the position its moves lead to
+		std::cout << "Moves before the checkpoint cannot be taken back." << std::endl;
+		return false;
+	}
+	m_board = board;
+	m_played = played;
+	m_beforeCheckpoint.clear();
+	return true;
+}
+
+json Game::checkpointsToJson() const {
+	json checkpoints = json::array();
+	for (const Checkpoint& c : m_checkpoints) {
+		std::stringstream neverMoved, hash;
+		neverMoved << std::hex << c.snapshot.neverMoved;
+		hash << std::hex << c.snapshot.hash;
+		json checkpoint;
+		checkpoint[CHECKPOINT_MOVE] = c.move;
+		checkpoint[CHECKPOINT_BOARD] = std::string(c.snapshot.board, SQUARES);
+		checkpoint[CHECKPOINT_NEVER_MOVED] = neverMoved.str();
+		checkpoint[CHECKPOINT_TURN] = c.snapshot.turn;
+		checkpoint[CHECKPOINT_HASH] = hash.str();
+		checkpoints.push_back(checkpoint);
+	}
+	return checkpoints;
+}
+
+bool Game::checkpointFromJson(const json& saved, const int& moves, Checkpoint& checkpoint) {
+	try {
+		std::string board = saved.at(CHECKPOINT_BOARD).get<std::string>();
+		if (board.size() != SQUARES) {
+			return false;
+		}
+		checkpoint.move = saved.at(CHECKPOINT_MOVE).get<int>();
+		std::copy(board.begin(), board.end(), checkpoint.snapshot.board);
+		checkpoint.snapshot.neverMoved = std::stoull(saved.at(CHECKPOINT_NEVER_MOVED).get<std::string>(), nullptr, 16);
+		checkpoint.snapshot.turn = saved.at(CHECKPOINT_TURN).get<int>();
+		checkpoint.snapshot.hash = std::stoull(saved.at(CHECKPOINT_HASH).get<std::string>(), nullptr, 16);
+	} catch (const std::exception&) {	//missing key, wrong type, or not hex
+		return false;
+	}
+	if (checkpoint.move < 0 || checkpoint.move > moves) {	//load would read moves that don't exist
+		throw std::invalid_argument("Checkpoint at move " + std::to_string(checkpoint.move) + " is outside the "
+			+ std::to_string(moves) + " move(s) of the save. Try again.");
+	}
+	return true;
+}
@@ -3,14 +3,22 @@
 
 #include "board.h"
 #include "history.h"
+#include "transposition_table.h"
 
 
 class Game {
 public:
 	/*
 		@brief		calls reset()
+
+		@param		hashMegabytes	size of the transposition table used for computer moves
+		@param		hugePages		if true, back the transposition table with huge pages where supported
+		@param		threads			number of threads computer moves are searched with
+		@param		checkpointInterval	moves between position snapshots embedded in saves (0 for none)
+		@param		trusted			if true, load skips legality checks on saves whose checksum matches
 	*/
-	Game();
+	Game(const size_t& hashMegabytes = TranspositionTable::DEFAULT_MEGABYTES, const bool& hugePages = false, const int& threads = 1,
+		const int& checkpointInterval = CHECKPOINT_INTERVAL, const bool& trusted = false);
 
 	/*
 		@brief		loop of move, save, quit
@@ -22,16 +30,52 @@ public:
 	*/
 	void move();
 
+	/*
+		@brief		searches for a move for the side to move and plays it, within a time budget entered by user
+
+		@throw		std::invalid_argument if the time budget is not a number
+	*/
+	void computerMove();
+
+	/*
+		@brief		takes back the last move played, in memory: nothing is written to disk
+					(moves before a checkpoint restored by load are replayed from the initial board the first time one is taken back)
+
+		@return		false if there is no move to take back
+	*/
+	bool undo();
+
+	/*
+		@brief		plays again the last move taken back by undo
+
+		@return		false if there is no move to redo (none was taken back, or a new move was played since)
+	*/
+	bool redo();
+
 	/*
 		@brief		loads game history file and inputs moves
+					if the file's checksum matches, the position is restored from the last checkpoint at or before
+					the requested move and only the moves after it are replayed (without legality checks if trusted)
 
 
 		@param		filename		name of file (without extension) to be loaded into history
 		@param		silent			if true, won't print success message
+		@param		upTo			number of moves to load, negative for all of them
+
+		@throw		invalid_argument if file contains illegal move(s) or a checkpoint outside its moves
+	*/
+	void load(const std::string& filename, const bool& silent = false, const int& upTo = -1);
+
+	/*
+		@brief		loads one game of a game database and inputs its moves, checking each for legality
+
+		@param		database		name of database file (without extension) in SAVE_DIR
+		@param		n				index of game in the database
+		@param		silent			if true, won't print success message
 
-		@throw		invalid_argument if file contains illegal move(s)
+		@throw		invalid_argument if the database cannot be opened or has no game n
 	*/
-	void load(const std::string& filename, const bool& silent = false);
+	void loadFromDatabase(const std::string& database, const size_t& n, const bool& silent = false);
 
 	/*
 		@brief		resets game conditions to start
@@ -56,10 +100,64 @@ private:
 
 
 		@param		current		position chosen to move/capture from
+		@param		legal		legal moves of the side to move, from Board::generateLegalMoves
 
 		@throw		std::invalid_argument
 	*/
-	void listAvailable(const std::string& current);
+	void listAvailable(const Square& current, const std::vector<Move>& legal);
+
+	/*
+		@brief		records a move that has been played in history and on the undo stack, and passes the turn if it is over
+
+		@param		current		position of piece before moving
+		@param		future		position of piece after moving
+		@param		turnOver	value returned by Board::attemptMove
+		@param		undo		record from the board that takes the move back
+	*/
+	void recordMove(const std::string& current, const std::string& future, const bool& turnOver, const Board::Undo& undo);
+
+	/*
+		@brief		position after a number of moves, embedded in saves so loading can skip replaying them
+	*/
+	struct Checkpoint {
+		int move;
+		Board::Snapshot snapshot;
+	};
+
+	/*
+		@return		m_checkpoints in the form History::save embeds them
+	*/
+	json checkpointsToJson() const;
+
+	/*
+		@param		saved		one checkpoint from a save file
+		@param		moves		number of moves in the save file
+		@param		checkpoint	receives the move number and position of the checkpoint
+
+		@return		false if saved is malformed
+
+		@throw		invalid_argument if the move of the checkpoint is negative or past moves
+	*/
+	static bool checkpointFromJson(const json& saved, const int& moves, Checkpoint& checkpoint);
+
+	/*
+		@brief		replays m_beforeCheckpoint from the initial board to give those moves undo records, once undo has
+					taken back every move after the checkpoint
+
+		@return		false (and nothing changes) if they are illegal or don't lead to the checkpoint's position
+	*/
+	bool replayBeforeCheckpoint();
+
+	/*
+		@brief		a move that was played, with what is needed to take it back and play it again
+	*/
+	struct Played {
+		Board::Undo undo;
+		std::string current;
+		std::string future;
+		int turn;			//m_turn before the move
+		bool turnOver;
+	};
 
 	//Member variables
 	//----------------
@@ -79,10 +177,48 @@ private:
 	*/
 	History m_history;
 
+	/*
+		@brief		every move played since reset, last on top; undo pops from here onto m_undone
+	*/
+	std::vector<Played> m_played;
+
+	/*
+		@brief		moves taken back by undo, last on top; cleared whenever a new move is played
+	*/
+	std::vector<Played> m_undone;
+
+	/*
+		@brief		moves before the checkpoint load restored, in order; they were never played on m_board, so they have
+					no undo records until undo reaches the checkpoint and replays them from the start
+	*/
+	std::vector<Played> m_beforeCheckpoint;
+
+	/*
+		@brief		snapshot every m_checkpointInterval moves of the game so far, in order
+	*/
+	std::vector<Checkpoint> m_checkpoints;
+
+	int m_checkpointInterval;
+
+	/*
+		@brief		if true, load replays saves with a matching checksum without checking legality
+	*/
+	bool m_trusted;
+
 	/*
 		@brief		name of rules game is being played under (from ruleset.json)
 	*/
 	std::string m_rules_name;
+
+	/*
+		@brief		search results kept between computer moves (and games: positions are keyed by hash, not by game)
+	*/
+	TranspositionTable m_tt;
+
+	/*
+		@brief		number of threads computer moves are searched with
+	*/
+	int m_threads;
 };
 
 #endif GAME_H
@@ -0,0 +1,292 @@
+#include <fstream>		// std::ifstream, std::fstream
+#include <sstream>		// std::ostringstream
+#include <iomanip>		// std::setw
+#include <thread>		// std::thread
+#include <atomic>		// std::atomic
+#include <algorithm>	// std::min, std::max, std::equal
+#include <chrono>		// std::chrono::steady_clock
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>	// CreateFileMapping, MapViewOfFile
+#else
+#include <fcntl.h>		// open
+#include <unistd.h>		// close
+#include <sys/mman.h>	// mmap
+#include <sys/stat.h>	// fstat
+#endif
+
+#include "constants.h"
+#include "game_database.h"
+#include "validator.h"
+
+
+const uint16_t GameDatabase::DATABASE_VERSION;
+const size_t GameDatabase::HEADER_SIZE;
+
+namespace {
+	/*
+		@brief		appends value to bytes, little-endian
+	*/
+	void putU64(std::string& bytes, uint64_t value) {
+		for (int i = 0; i < 8; ++i, value >>= 8) {
+			bytes.push_back(char(value & 0xFF));
+		}
+	}
+
+	/*
+		@return		header of a database holding count games whose index starts at indexOffset
+	*/
+	std::string header(const uint64_t& count, const uint64_t& indexOffset) {
+		std::string bytes = DATABASE_MAGIC;
+		bytes.push_back(char(GameDatabase::DATABASE_VERSION & 0xFF));
+		bytes.push_back(char(GameDatabase::DATABASE_VERSION >> 8));
+		bytes.append(2, '\0');
+		putU64(bytes, count);
+		putU64(bytes, indexOffset);
+		putU64(bytes, 0);
+		return bytes;
+	}
+}
+
+
+// Public
+// ------
+GameDatabase::GameDatabase(const std::string& path) : m_path(path), m_data(nullptr), m_size(0), m_count(0), m_indexOffset(HEADER_SIZE) {
+	if (!std::ifstream(path, std::ios::binary).is_open()) {	//create an empty database
+		std::ofstream ofs(path, std::ios::binary);
+		if (!ofs.is_open()) {
+			throw std::invalid_argument("Cannot create database " + path);
+		}
+		ofs << header(0, HEADER_SIZE);
+	}
+	map();
+}
+
+GameDatabase::~GameDatabase() {
+	unmap();
+}
+
+size_t GameDatabase::size() const {
+	return size_t(m_count);
+}
+
+GameRecordView GameDatabase::game(const size_t& n) const {
+	if (n >= m_count) {
+		throw std::invalid_argument("There is no game " + std::to_string(n) + " in the database.");
+	}
+	uint64_t begin = u64(m_indexOffset + 8 * n);
+	uint64_t end = (n + 1 < m_count) ? u64(m_indexOffset + 8 * (n + 1)) : m_indexOffset;
+	if (begin < HEADER_SIZE || end > m_indexOffset || begin > end) {
+		throw std::invalid_argument("Index of game " + std::to_string(n) + " is damaged.");
+	}
+	return GameRecord::view(m_data + begin, size_t(end - begin));
+}
+
+void GameDatabase::append(const std::vector<GameRecord>& games) {
+	//records and a whole new index go past the end of the file, so the old header keeps describing a complete
+	//database until it is rewritten last; the old index is left behind, unused
+	uint64_t recordsOffset = uint64_t(m_size);
+	std::string index(reinterpret_cast<const char*>(m_data + m_indexOffset), size_t(8 * m_count));
+	std::ostringstream records;
+	for (const GameRecord& game : games) {
+		putU64(index, recordsOffset + uint64_t(records.tellp()));
+		game.write(records);
+	}
+	uint64_t count = m_count + games.size();
+	uint64_t indexOffset = recordsOffset + uint64_t(records.tellp());
+	unmap();
+	bool written;
+	{
+		std::fstream fs(m_path, std::ios::in | std::ios::out | std::ios::binary);
+		if (!fs.is_open()) {
+			map();
+			throw std::invalid_argument("Cannot write to database " + m_path);
+		}
+		fs.seekp(std::streamoff(recordsOffset));
+		fs << records.str() << index;
+		written = bool(fs.flush());
+		if (written) {	//never point the header at records that didn't make it
+			fs.seekp(0);
+			fs << header(count, indexOffset);
+			written = bool(fs.flush());
+		}
+	}
+	map();
+	if (!written) {
+		throw std::invalid_argument("Writing to database " + m_path + " failed.");
+	}
+}
+
+void GameDatabase::forEach(const int& threads, const std::function<void(const int&, const size_t&, const GameRecordView&)>& visit) const {
+	std::atomic<size_t> next(0);
+	auto work = [&](const int& thread) {
+		for (size_t begin = next.fetch_add(DATABASE_BLOCK); begin < m_count; begin = next.fetch_add(DATABASE_BLOCK)) {
+			for (size_t n = begin; n < std::min(begin + DATABASE_BLOCK, size_t(m_count)); ++n) {
+				try {
+					visit(thread, n, game(n));
+				} catch (const std::invalid_argument&) {	//damaged record
+				}
+			}
+		}
+	};
+	std::vector<std::thread> workers;
+	for (int t = 1; t < threads; ++t) {
+		workers.emplace_back(work, t);
+	}
+	work(0);
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+int GameDatabase::run(const std::vector<std::string>& args) {
+	try {
+		if (args.size() >= 3 && args[1] == DATABASE_ADD) {
+			std::vector<GameRecord> games;
+			for (size_t i = 2; i < args.size(); ++i) {
+				const std::string& path = args[i];
+				std::ifstream ifs(path, std::ios::binary);
+				if (!ifs.is_open()) {
+					throw std::invalid_argument("Cannot open " + path);
+				}
+				bool record = (path.size() >= RECORD_EXT.size() && path.compare(path.size() - RECORD_EXT.size(), RECORD_EXT.size(), RECORD_EXT) == 0);
+				games.push_back(record ? GameRecord::read(ifs) : GameRecord::fromJson(json::parse(ifs)));
+			}
+			GameDatabase db(args[0]);
+			db.append(games);
+			std::cout << "Added " << games.size() << " game(s); " << args[0] << " holds " << db.size() << std::endl;
+			return 0;
+		} else if (args.size() == 2 && args[1] == DATABASE_INFO) {
+			GameDatabase db(args[0]);
+			std::atomic<long long> moves(0);
+			db.forEach(1, [&](const int&, const size_t&, const GameRecordView& game) { moves += game.count; });
+			std::cout << db.size() << " games, " << moves << " moves, " << db.m_size << " bytes" << std::endl;
+			return 0;
+		} else if ((args.size() == 2 || args.size() == 3) && args[1] == DATABASE_VALIDATE) {
+			GameDatabase db(args[0]);
+			int threads = (args.size() == 3) ? std::stoi(args[2]) : int(std::thread::hardware_concurrency());
+			std::vector<ValidationResult> results(db.size());
+			std::vector<char> visited(db.size(), 0);	//left 0 for damaged records
+			threads = std::max(threads, 1);
+			std::vector<Board> boards(threads);	//one per thread, reset to the rules of every game it replays
+			auto start = std::chrono::steady_clock::now();
+			db.forEach(threads, [&](const int& thread, const size_t& n, const GameRecordView& game) {
+				results[n] = Validator::validateRecord(boards[thread], game, std::to_string(n));
+				visited[n] = 1;
+			});
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			int invalid = 0;
+			for (size_t n = 0; n < results.size(); ++n) {
+				if (!visited[n]) {
+					std::cout << "game " << n << "\tdamaged record" << std::endl;
+					++invalid;
+				} else if (!results[n].valid) {
+					std::cout << "game " << n << "\tmove " << results[n].badMove << '\t' << results[n].reason << std::endl;
+					++invalid;
+				}
+			}
+			std::cout << db.size() << " games, " << invalid << " invalid, " << seconds << " s with " << threads << " threads" << std::endl;
+			return invalid ? 1 : 0;
+		} else if (args.size() == 4 && args[1] == DATABASE_EXPORT) {
+			GameDatabase db(args[0]);
+			GameRecordView view = db.game(std::stoul(args[2]));
+			GameRecord game;
+			game.rules = std::string(view.rules);
+			game.time = std::string(view.time);
+			for (uint32_t i = 0; i < view.count; ++i) {
+				game.moves.push_back(view.move(i));
+			}
+			std::ofstream ofs(args[3]);
+			if (!ofs.is_open()) {
+				throw std::invalid_argument("Cannot create " + args[3]);
+			}
+			ofs << std::setw(2) << game.toJson() << std::endl;
+			return 0;
+		}
+		std::cout << "Usage: " << DATABASE << " <file> " << DATABASE_ADD << " <save>...\t|\t" << DATABASE_INFO << "\t|\t"
+			<< DATABASE_VALIDATE << " [<threads>]\t|\t" << DATABASE_EXPORT << " <n> <save>" << std::endl;
+		return 1;
+	} catch (const std::exception& e) {	//unreadable files, bad numbers, damaged database
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
+
+// Private
+// -------
+void GameDatabase::map() {
+#ifdef _WIN32
+	m_file = CreateFileA(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE) {
+		throw std::invalid_argument("Cannot open database " + m_path);
+	}
+	LARGE_INTEGER size;
+	GetFileSizeEx(m_file, &size);
+	m_size = size_t(size.QuadPart);
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	m_data = m_mapping ? static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+#else
+	m_file = open(m_path.c_str(), O_RDONLY);
+	if (m_file < 0) {
+		throw std::invalid_argument("Cannot open database " + m_path);
+	}
+	struct stat st;
+	fstat(m_file, &st);
+	m_size = size_t(st.st_size);
+	void* data = (m_size > 0) ? mmap(nullptr, m_size, PROT_READ, MAP_SHARED, m_file, 0) : MAP_FAILED;
+	m_data = (data == MAP_FAILED) ? nullptr : static_cast<const unsigned char*>(data);
+#endif
+	if (!m_data) {
+		unmap();
+		throw std::invalid_argument("Cannot map database " + m_path);
+	}
+	if (m_size < HEADER_SIZE || !std::equal(DATABASE_MAGIC.begin(), DATABASE_MAGIC.end(), m_data)) {
+		unmap();
+		throw std::invalid_argument(m_path + " is not a game database.");
+	}
+	if ((m_data[4] | (m_data[5] << 8)) != DATABASE_VERSION) {
+		unmap();
+		throw std::invalid_argument("Unsupported game database version.");
+	}
+	m_count = u64(8);
+	m_indexOffset = u64(16);
+	if (m_indexOffset < HEADER_SIZE || m_indexOffset > m_size || (m_size - m_indexOffset) / 8 < m_count) {
+		unmap();
+		throw std::invalid_argument(m_path + " is damaged.");
+	}
+}
+
+void GameDatabase::unmap() {
+#ifdef _WIN32
+	if (m_data) {
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping) {
+		CloseHandle(m_mapping);
+	}
+	if (m_file != INVALID_HANDLE_VALUE) {
+		CloseHandle(m_file);
+	}
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+#else
+	if (m_data) {
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	}
+	if (m_file >= 0) {
+		close(m_file);
+	}
+	m_file = -1;
+#endif
+	m_data = nullptr;
+	m_size = 0;
+}
+
+uint64_t GameDatabase::u64(const uint64_t& pos) const {
+	uint64_t value = 0;
+	for (int i = 7; i >= 0; --i) {
+		value = (value << 8) | m_data[pos + i];
+	}
+	return value;
+}
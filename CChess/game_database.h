@@ -0,0 +1,142 @@
+#ifndef GAME_DATABASE_H
+#define GAME_DATABASE_H
+
+#include <functional>
+
+#include "game_record.h"
+
+
+/*
+	@brief		single file of game records, memory-mapped for reading: game N is found in O(1) through an index of offsets
+				and is read in place, without copying or a system call per game
+
+				offset			size			contents (integers little-endian)
+				0				4				DATABASE_MAGIC
+				4				2				format version (DATABASE_VERSION)
+				6				2				reserved
+				8				8				number of games
+				16				8				offset of index
+				24				8				reserved
+				32				...				game records (see GameRecord), in the order appended
+				index			8 each			offset of every game record
+
+				appending writes the new records and a new index of every game past the end of the file, then rewrites the
+				header to point at them, so a process that dies mid-append leaves the previous database intact (disk
+				write order is up to the OS); the cost is the whole index per append, and superseded indexes stay in the
+				file as unused bytes
+*/
+class GameDatabase {
+public:
+	/*
+		@brief		opens a database, creating an empty one if path does not exist
+
+		@param		path		path of database file
+
+		@throw		std::invalid_argument if path cannot be created, opened or mapped, or is not a database
+	*/
+	GameDatabase(const std::string& path);
+
+	~GameDatabase();
+
+	GameDatabase(const GameDatabase&) = delete;
+	GameDatabase& operator=(const GameDatabase&) = delete;
+
+	/*
+		@return		number of games in the database
+	*/
+	size_t size() const;
+
+	/*
+		@param		n			index of game, from 0 to size() - 1
+
+		@return		view of game n inside the mapping; valid until the next append or until the database is closed
+
+		@throw		std::invalid_argument if n is out of range or the record is damaged
+	*/
+	GameRecordView game(const size_t& n) const;
+
+	/*
+		@brief		appends games to the end of the database and remaps it (not thread safe; invalidates every view)
+
+		@param		games		games to append
+
+		@throw		std::invalid_argument if a game cannot be stored (nothing is written), the file cannot be opened or a write
+					fails (the header is only rewritten once the records and index are written)
+	*/
+	void append(const std::vector<GameRecord>& games);
+
+	/*
+		@brief		calls visit on every game from a pool of threads; games are handed out in blocks of DATABASE_BLOCK
+					visit must be safe to call from several threads at once
+
+		@param		threads		number of threads (at least 1)
+		@param		visit		called with the index of the calling thread (0 to threads - 1), and the index and view
+								of every game; damaged records are skipped
+	*/
+	void forEach(const int& threads, const std::function<void(const int&, const size_t&, const GameRecordView&)>& visit) const;
+
+	/*
+		@brief		entry point of the headless database mode, see main.cpp
+					db <file> add <save>...				appends JSON saves or records (RECORD_EXT) to the database
+					db <file> info						prints the number of games and moves
+					db <file> validate [<threads>]		replays every game in parallel and prints those with illegal moves
+					db <file> export <n> <save>			writes game n as a JSON save
+
+		@param		args		command line arguments following "db"
+
+		@return		process exit code
+	*/
+	static int run(const std::vector<std::string>& args);
+
+	static const uint16_t DATABASE_VERSION = 1;
+	static const size_t HEADER_SIZE = 32;
+
+private:
+	/*
+		@brief		maps the whole file read-only and reads the header
+	*/
+	void map();
+
+	/*
+		@brief		unmaps the file
+	*/
+	void unmap();
+
+	/*
+		@param		pos			offset into the mapping, at least 8 bytes before its end
+
+		@return		little-endian 64 bit integer at pos
+	*/
+	uint64_t u64(const uint64_t& pos) const;
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		path of database file
+	*/
+	std::string m_path;
+
+	/*
+		@brief		start and size of the mapping
+	*/
+	const unsigned char* m_data;
+	size_t m_size;
+
+	/*
+		@brief		header fields: number of games and where their offsets are stored
+	*/
+	uint64_t m_count;
+	uint64_t m_indexOffset;
+
+	/*
+		@brief		OS handles of the mapping (file descriptor on POSIX; file and mapping handles on Windows)
+	*/
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#else
+	int m_file;
+#endif
+};
+
+#endif GAME_DATABASE_H
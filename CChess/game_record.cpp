@@ -0,0 +1,196 @@
+#include <fstream>		// std::ifstream, std::ofstream
+#include <iterator>		// std::istreambuf_iterator
+#include <algorithm>	// std::equal
+#include <iomanip>		// std::setw
+#include <sstream>		// std::ostringstream
+
+#include "constants.h"
+#include "game_record.h"
+
+
+const uint16_t GameRecord::RECORD_VERSION;
+
+static_assert(SQUARES <= 64, "packed moves hold squares in 6 bits");
+
+
+// Public
+// ------
+GameRecord::GameRecord() {
+}
+
+GameRecord GameRecord::fromJson(const json& file) {
+	GameRecord record;
+	record.rules = file.at(SAVE_RULES).get<std::string>();
+	record.time = (file.find(SAVE_TIME) != file.end()) ? file.at(SAVE_TIME).get<std::string>() : "";
+	if (file.find(SAVE_ROUND) == file.end()) {	//nothing was played
+		return record;
+	}
+	const json& rounds = file.at(SAVE_ROUND);
+	for (int i = 0; i < int(rounds.size()); ++i) {
+		for (const std::string& side : { SAVE_WHITE_TURN, SAVE_BLACK_TURN }) {
+			const json& turn = rounds.at(std::to_string(i)).at(side);
+			for (size_t m = 0; m < turn.size(); ++m) {
+				Square current = toSquare(turn.at(m).at(0).get<std::string>()), future = toSquare(turn.at(m).at(1).get<std::string>());
+				if (current == NO_SQUARE || future == NO_SQUARE) {
+					throw std::invalid_argument("Move " + std::to_string(record.moves.size()) + " is not a pair of positions.");
+				}
+				record.moves.push_back(pack(current, future, m + 1 == turn.size()));	//a turn ends with its last move
+			}
+		}
+	}
+	return record;
+}
+
+json GameRecord::toJson() const {
+	json file;
+	file[SAVE_RULES] = rules;
+	file[SAVE_TIME] = time;
+	int round = 0;
+	int side = WHITE;
+	for (const uint16_t& move : moves) {
+		json& turns = file[SAVE_ROUND][std::to_string(round)];
+		if (turns.is_null()) {	//History::save writes both turns of every round
+			turns[SAVE_WHITE_TURN] = json::array();
+			turns[SAVE_BLACK_TURN] = json::array();
+		}
+		turns[(side == WHITE) ? SAVE_WHITE_TURN : SAVE_BLACK_TURN].push_back({ toAlgebraic(current(move)), toAlgebraic(future(move)) });
+		if (turnOver(move)) {
+			round += (side == BLACK) ? 1 : 0;
+			side = !side;
+		}
+	}
+	return file;
+}
+
+GameRecord GameRecord::read(std::istream& in) {
+	//one read of the whole record, then decoded from memory
+	std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	GameRecordView view = GameRecord::view(bytes.data(), bytes.size());
+	GameRecord record;
+	record.rules = std::string(view.rules);
+	record.time = std::string(view.time);
+	record.moves.resize(view.count);
+	for (uint32_t i = 0; i < view.count; ++i) {
+		record.moves[i] = view.move(i);
+	}
+	return record;
+}
+
+GameRecordView GameRecord::view(const unsigned char* data, const size_t& size) {
+	size_t pos = 0;
+	auto need = [&](const size_t& n) {
+		if (size - pos < n) {
+			throw std::invalid_argument("Record is truncated.");
+		}
+	};
+	auto u16 = [&]() {
+		need(2);
+		uint16_t value = uint16_t(data[pos] | (data[pos + 1] << 8));
+		pos += 2;
+		return value;
+	};
+	auto text = [&]() {
+		need(1);
+		size_t length = data[pos++];
+		need(length);
+		std::string_view value(reinterpret_cast<const char*>(data + pos), length);
+		pos += length;
+		return value;
+	};
+
+	need(RECORD_MAGIC.size());
+	if (!std::equal(RECORD_MAGIC.begin(), RECORD_MAGIC.end(), data)) {
+		throw std::invalid_argument("Not a game record.");
+	}
+	pos += RECORD_MAGIC.size();
+	if (u16() != RECORD_VERSION) {
+		throw std::invalid_argument("Unsupported game record version.");
+	}
+	GameRecordView view;
+	view.rules = text();
+	view.time = text();
+	view.count = u16();
+	view.count |= uint32_t(u16()) << 16;
+	need(size_t(view.count) * 2);
+	view.moves = data + pos;
+	return view;
+}
+
+void GameRecord::write(std::ostream& out) const {
+	//built in memory, then one write
+	std::vector<unsigned char> bytes(RECORD_MAGIC.begin(), RECORD_MAGIC.end());
+	bytes.reserve(RECORD_MAGIC.size() + 2 + 2 + rules.size() + time.size() + 4 + moves.size() * 2);
+	auto u16 = [&](const uint16_t& value) {
+		bytes.push_back(value & 0xFF);
+		bytes.push_back(value >> 8);
+	};
+	auto text = [&](const std::string& key, const std::string& value) {
+		if (value.size() > 0xFF) {	//length is stored in one byte
+			throw std::invalid_argument("The " + key + " of the game is longer than 255 bytes and cannot be stored in a record.");
+		}
+		bytes.push_back((unsigned char)value.size());
+		bytes.insert(bytes.end(), value.begin(), value.end());
+	};
+	u16(RECORD_VERSION);
+	text(SAVE_RULES, rules);
+	text(SAVE_TIME, time);
+	u16(uint16_t(moves.size() & 0xFFFF));
+	u16(uint16_t(moves.size() >> 16));
+	for (const uint16_t& move : moves) {
+		u16(move);
+	}
+	out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+uint16_t GameRecord::pack(const Square& current, const Square& future, const bool& turnOver) {
+	return uint16_t(current | (future << 6) | (turnOver ? (1 << 12) : 0));
+}
+
+Square GameRecord::current(const uint16_t& move) {
+	return move & 0x3F;
+}
+
+Square GameRecord::future(const uint16_t& move) {
+	return (move >> 6) & 0x3F;
+}
+
+bool GameRecord::turnOver(const uint16_t& move) {
+	return (move >> 12) & 1;
+}
+
+int GameRecord::run(const std::vector<std::string>& args) {
+	if (args.size() != 2) {
+		std::cout << "Usage: " << CONVERT << " <from> <to>\t(a " << RECORD_EXT << " file converts to JSON, anything else to " << RECORD_EXT << ")" << std::endl;
+		return 1;
+	}
+	const std::string& from = args[0];
+	const std::string& to = args[1];
+	bool fromRecord = (from.size() >= RECORD_EXT.size() && from.compare(from.size() - RECORD_EXT.size(), RECORD_EXT.size(), RECORD_EXT) == 0);
+	try {
+		//read and converted in full before to is opened, which truncates it (to may even be from)
+		GameRecord record;
+		{
+			std::ifstream ifs(from, std::ios::binary);
+			if (!ifs.is_open()) {
+				throw std::invalid_argument("Cannot open " + from);
+			}
+			record = fromRecord ? read(ifs) : fromJson(json::parse(ifs));
+		}
+		std::ostringstream converted;
+		if (fromRecord) {
+			converted << std::setw(2) << record.toJson() << std::endl;
+		} else {
+			record.write(converted);
+		}
+		std::ofstream ofs(to, std::ios::binary);
+		if (!ofs.is_open()) {
+			throw std::invalid_argument("Cannot create " + to);
+		}
+		ofs << converted.str();
+		std::cout << "Converted " << from << " to " << to << std::endl;
+		return 0;
+	} catch (const std::exception& e) {	//unreadable, not a save, or not a record
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
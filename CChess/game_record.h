@@ -0,0 +1,155 @@
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+// for convenience
+using json = nlohmann::json;
+
+#include "square.h"
+
+
+/*
+	@brief		read-only view of a game record held in memory someone else owns (e.g. a memory-mapped GameDatabase)
+				nothing is copied; the view is only valid while that memory is
+*/
+struct GameRecordView {
+	std::string_view rules;
+	std::string_view time;
+	const unsigned char* moves;		//packed moves, 2 bytes each, little-endian
+	uint32_t count;					//number of moves
+
+	/*
+		@param		i			index of move, from 0 to count - 1
+
+		@return		packed move i (see GameRecord::pack)
+	*/
+	uint16_t move(const uint32_t& i) const { return uint16_t(moves[2 * i] | (moves[2 * i + 1] << 8)); }
+};
+
+/*
+	@brief		compact binary form of a saved game, for archiving: a small header followed by 16 bits per move
+
+				offset	size		contents (integers little-endian)
+				0		4			RECORD_MAGIC
+				4		2			format version (RECORD_VERSION)
+				6		1 + n		length and chars of rules name
+				...		1 + n		length and chars of time saved, as in SAVE_TIME
+				...		4			number of moves
+				...		2 each		packed moves: bits 0-5 current, 6-11 future, 12 set if the move ended the turn
+
+				checkpoints and checksums of JSON saves are not kept: a record is always replayed in full
+*/
+class GameRecord {
+public:
+	/*
+		@brief		empty record
+	*/
+	GameRecord();
+
+	/*
+		@param		file		contents of a JSON save (see History::save)
+
+		@return		record of the same game
+
+		@throw		std::invalid_argument if a move is not a pair of valid positions
+	*/
+	static GameRecord fromJson(const json& file);
+
+	/*
+		@return		contents of a JSON save of the same game, as History::save lays it out
+	*/
+	json toJson() const;
+
+	/*
+		@param		in			stream opened in binary mode, positioned at the start of a record
+
+		@return		record read from in
+
+		@throw		std::invalid_argument if in does not hold a record of a supported version
+	*/
+	static GameRecord read(std::istream& in);
+
+	/*
+		@param		data		bytes of a record
+		@param		size		number of bytes available at data
+
+		@return		view of the record inside data
+
+		@throw		std::invalid_argument if data does not hold a record of a supported version
+	*/
+	static GameRecordView view(const unsigned char* data, const size_t& size);
+
+	/*
+		@param		out			stream opened in binary mode
+
+		@throw		std::invalid_argument if rules or time is longer than 255 bytes (nothing is written)
+	*/
+	void write(std::ostream& out) const;
+
+	/*
+		@param		current		position of piece before moving
+		@param		future		position of piece after moving
+		@param		turnOver	true if the move ended its side's turn
+
+		@return		move packed into 16 bits
+	*/
+	static uint16_t pack(const Square& current, const Square& future, const bool& turnOver);
+
+	/*
+		@param		move		packed move
+
+		@return		position of piece before moving
+	*/
+	static Square current(const uint16_t& move);
+
+	/*
+		@param		move		packed move
+
+		@return		position of piece after moving
+	*/
+	static Square future(const uint16_t& move);
+
+	/*
+		@param		move		packed move
+
+		@return		true if the move ended its side's turn
+	*/
+	static bool turnOver(const uint16_t& move);
+
+	/*
+		@brief		entry point of the headless convert mode, see main.cpp
+					convert <from> <to>		converts a JSON save to a record, or a record (RECORD_EXT) to a JSON save
+
+		@param		args		command line arguments following "convert"
+
+		@return		process exit code
+	*/
+	static int run(const std::vector<std::string>& args);
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		name of rules object the game was played under
+	*/
+	std::string rules;
+
+	/*
+		@brief		time the game was saved at, as in SAVE_TIME
+	*/
+	std::string time;
+
+	/*
+		@brief		every move in the order played, packed by pack()
+	*/
+	std::vector<uint16_t> moves;
+
+	static const uint16_t RECORD_VERSION = 1;
+};
+
+#endif GAME_RECORD_H
@@ -0,0 +1,319 @@
+#ifndef GEOMETRY_H
+#define GEOMETRY_H
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+
+/*
+	@brief		compact position on a board: row * size + col, so a1 = 0 and the last square of the last row is squares - 1
+				algebraic strings only exist at the Game/History boundary
+*/
+typedef int Square;
+
+const Square NO_SQUARE = -1;
+
+/*
+	@param		b			non-empty 64 bit mask
+
+	@return		index of the lowest bit set in b
+*/
+inline int lowestBit(const uint64_t& b) {
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return int(index);
+#elif defined(_MSC_VER)		//no 64 bit scan on Win32
+	unsigned long index;
+	if (_BitScanForward(&index, static_cast<unsigned long>(b))) {
+		return int(index);
+	}
+	_BitScanForward(&index, static_cast<unsigned long>(b >> 32));
+	return int(index + 32);
+#else
+	return __builtin_ctzll(b);
+#endif
+}
+
+/*
+	@param		b			non-empty 64 bit mask
+
+	@return		index of the highest bit set in b
+*/
+inline int highestBit(const uint64_t& b) {
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanReverse64(&index, b);
+	return int(index);
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, static_cast<unsigned long>(b >> 32))) {
+		return int(index + 32);
+	}
+	_BitScanReverse(&index, static_cast<unsigned long>(b));
+	return int(index);
+#else
+	return 63 - __builtin_clzll(b);
+#endif
+}
+
+/*
+	@brief		set of squares of a board too big for 64 bits: one bit per square over Words 64 bit words (bit 0 of
+				words[0] is a1); has the operators of an integer mask, so code written against a mask works with either
+*/
+template <int Words>
+struct WideMask {
+	uint64_t words[Words];
+
+	constexpr WideMask() : words() {}
+
+	constexpr WideMask(const uint64_t& low) : words() {
+		words[0] = low;
+	}
+
+	constexpr explicit operator bool() const {
+		for (int i = 0; i < Words; ++i) {
+			if (words[i]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	constexpr bool operator!() const {
+		return !bool(*this);
+	}
+
+	constexpr bool operator==(const WideMask& other) const {
+		for (int i = 0; i < Words; ++i) {
+			if (words[i] != other.words[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr bool operator!=(const WideMask& other) const {
+		return !(*this == other);
+	}
+
+	constexpr WideMask operator~() const {
+		WideMask result;
+		for (int i = 0; i < Words; ++i) {
+			result.words[i] = ~words[i];
+		}
+		return result;
+	}
+
+	constexpr WideMask& operator&=(const WideMask& other) {
+		for (int i = 0; i < Words; ++i) {
+			words[i] &= other.words[i];
+		}
+		return *this;
+	}
+
+	constexpr WideMask& operator|=(const WideMask& other) {
+		for (int i = 0; i < Words; ++i) {
+			words[i] |= other.words[i];
+		}
+		return *this;
+	}
+
+	constexpr WideMask& operator^=(const WideMask& other) {
+		for (int i = 0; i < Words; ++i) {
+			words[i] ^= other.words[i];
+		}
+		return *this;
+	}
+
+	constexpr WideMask operator&(const WideMask& other) const {
+		return WideMask(*this) &= other;
+	}
+
+	constexpr WideMask operator|(const WideMask& other) const {
+		return WideMask(*this) |= other;
+	}
+
+	constexpr WideMask operator^(const WideMask& other) const {
+		return WideMask(*this) ^= other;
+	}
+
+	constexpr WideMask operator<<(const int& shift) const {
+		WideMask result;
+		for (int i = Words - 1; i >= shift / 64; --i) {
+			result.words[i] = words[i - shift / 64] << (shift % 64);
+			if (shift % 64 && i - shift / 64 - 1 >= 0) {
+				result.words[i] |= words[i - shift / 64 - 1] >> (64 - shift % 64);
+			}
+		}
+		return result;
+	}
+
+	/*
+		@return		mask with the lowest set bit cleared, like b & (b - 1) of an integer mask
+	*/
+	constexpr WideMask withoutLowest() const {
+		WideMask result(*this);
+		for (int i = 0; i < Words; ++i) {
+			if (result.words[i]) {
+				result.words[i] &= result.words[i] - 1;
+				break;
+			}
+		}
+		return result;
+	}
+
+	/*
+		@return		index of the lowest bit set (the mask must not be empty)
+	*/
+	int lowest() const {
+		int i = 0;
+		while (!words[i]) {
+			++i;
+		}
+		return 64 * i + lowestBit(words[i]);
+	}
+
+	/*
+		@return		index of the highest bit set (the mask must not be empty)
+	*/
+	int highest() const {
+		int i = Words - 1;
+		while (!words[i]) {
+			--i;
+		}
+		return 64 * i + highestBit(words[i]);
+	}
+};
+
+/*
+	@param		b			non-empty mask
+
+	@return		index of the lowest bit set in b
+*/
+template <int Words>
+inline int lowestBit(const WideMask<Words>& b) {
+	return b.lowest();
+}
+
+/*
+	@param		b			non-empty mask
+
+	@return		index of the highest bit set in b
+*/
+template <int Words>
+inline int highestBit(const WideMask<Words>& b) {
+	return b.highest();
+}
+
+/*
+	@param		b			mask
+
+	@return		b with its lowest set bit cleared
+*/
+inline uint64_t withoutLowestBit(const uint64_t& b) {
+	return b & (b - 1);
+}
+
+template <int Words>
+inline WideMask<Words> withoutLowestBit(const WideMask<Words>& b) {
+	return b.withoutLowest();
+}
+
+/*
+	@brief		geometry of a Size x Size board, all worked out at compile time: square numbering, the smallest
+				mask type with a bit per square (a 64 bit integer up to 8x8, a WideMask above), and algebraic notation
+				with one letter per column and the row number (so "a10" on boards of 10 rows or more)
+*/
+template <int Size>
+struct Geometry {
+	static_assert(Size > 0 && Size <= 26, "columns are named by a single letter");
+
+	static constexpr int SIZE = Size;
+	static constexpr int SQUARES = Size * Size;
+
+	typedef typename std::conditional<(SQUARES <= 64), uint64_t, WideMask<(SQUARES + 63) / 64>>::type Mask;
+
+	/*
+		@param		row			row in board array
+		@param		col			column in board array
+
+		@return		square at row and col, or NO_SQUARE if either is off the board
+	*/
+	static constexpr Square makeSquare(const int& row, const int& col) {
+		return (row >= 0 && row < Size && col >= 0 && col < Size) ? row * Size + col : NO_SQUARE;
+	}
+
+	/*
+		@param		sq			square on the board
+
+		@return		row of sq in board array
+	*/
+	static constexpr int rowOf(const Square& sq) {
+		return sq / Size;
+	}
+
+	/*
+		@param		sq			square on the board
+
+		@return		column of sq in board array
+	*/
+	static constexpr int colOf(const Square& sq) {
+		return sq % Size;
+	}
+
+	/*
+		@param		sq			square on the board
+
+		@return		mask with only sq set
+	*/
+	static constexpr Mask squareBit(const Square& sq) {
+		return Mask(1) << sq;
+	}
+
+	/*
+		@param		pos			position in algebraic notation, e.g. "e4"
+		@param		firstCol	letter of the first column
+		@param		firstRow	digit of the first row
+
+		@return		square of pos, or NO_SQUARE if pos is not contained within the board dimensions
+	*/
+	static Square toSquare(const std::string& pos, const char& firstCol, const char& firstRow) {
+		if (pos.size() < 2 || pos.size() > 1 + digits(Size) || (pos.size() > 2 && pos[1] == '0')) {	//no leading zeros
+			return NO_SQUARE;
+		}
+		int row = 0;
+		for (size_t i = 1; i < pos.size(); ++i) {
+			if (pos[i] < '0' || pos[i] > '9') {
+				return NO_SQUARE;
+			}
+			row = row * 10 + (pos[i] - '0');
+		}
+		return makeSquare(row - (firstRow - '0'), pos[0] - firstCol);
+	}
+
+	/*
+		@param		sq			square on the board
+		@param		firstCol	letter of the first column
+		@param		firstRow	digit of the first row
+
+		@return		sq in algebraic notation, e.g. "e4"
+	*/
+	static std::string toAlgebraic(const Square& sq, const char& firstCol, const char& firstRow) {
+		return char(firstCol + colOf(sq)) + std::to_string(rowOf(sq) + (firstRow - '0'));
+	}
+
+private:
+	/*
+		@return		number of decimal digits of n
+	*/
+	static constexpr size_t digits(const int& n) {
+		return (n < 10) ? 1 : 1 + digits(n / 10);
+	}
+};
+
+#endif GEOMETRY_H
@@ -1,12 +1,16 @@
 #include <iostream>		// std::cout
 #include <fstream>		// std::ofstream
 #include <sstream>		// std::stringstream
-#include <iomanip>		// std::put_time
+#include <iomanip>		// std::put_time, std::setw
+#include <algorithm>	// std::min
 
 #include "constants.h"
 #include "history.h"
+#include "square.h"
 
 
+// Public
+// ------
 History::History() {
 	reset();		//in future rounds, the end of black's turn will prepare the next Round
 }
@@ -14,8 +18,9 @@ History::History() {
 void History::reset() {
 	m_roundCount = 0;
 	m_moveCount = 0;
-	m_history.clear();
-	m_history.push_back(Round());
+	m_moves.clear();	//keeps capacity
+	m_rounds.clear();
+	m_rounds.push_back({ 0, 0 });
 }
 
 const int & History::rounds() {
@@ -27,17 +32,19 @@ const int & History::moves() {
 }
 
 void History::recordMove(const int& turn, const std::string& current, const std::string& future, const bool& last) {
+	if (turn != WHITE && turn != BLACK) {
+		return;
+	}
 	++m_moveCount;
+	Round& round = m_rounds.back();
+	if (turn == WHITE && round.black == round.white) {
+		++m_roundCount;	//new round has begun and will have a move recorded
+	}
+	m_moves.push_back({ pack(current), pack(future) });
 	if (turn == WHITE) {
-		if (m_history.back().white_turn.empty()) {
-			++m_roundCount;	//new round has begun and will have a move recorded
-		}
-		m_history.back().white_turn.push_back({ current, future });
-	} else if (turn == BLACK) {
-		m_history.back().black_turn.push_back({ current, future });
-		if (last) {
-			m_history.push_back(Round());
-		}
+		round.black = uint32_t(m_moves.size());	//Black's turn starts after White's
+	} else if (last) {
+		m_rounds.push_back({ uint32_t(m_moves.size()), uint32_t(m_moves.size()) });
 	}
 }
 
@@ -49,12 +56,14 @@ void History::print() const {
 		std::cout << "Round\tWhite\tBlack" << std::endl;
 		for (int i = 0; i < m_roundCount; ++i) {
 			std::cout << i << '\t';
-			for (auto& m : m_history[i].white_turn) {
-				std::cout << m[0] << '-' << m[1] << ' ';
+			for (uint32_t m = m_rounds[i].white; m < roundEnd(i); ++m) {
+				if (m == m_rounds[i].black) {
+					std::cout << '\t';
+				}
+				std::cout << unpack(m_moves[m].current) << '-' << unpack(m_moves[m].future) << ' ';
 			}
-			std::cout << '\t';
-			for (auto& m : m_history[i].black_turn) {
-				std::cout << m[0] << '-' << m[1] << ' ';
+			if (m_rounds[i].black == roundEnd(i)) {	//Black hasn't moved
+				std::cout << '\t';
 			}
 			std::cout << std::endl;
 		}
@@ -62,7 +71,7 @@ void History::print() const {
 	std::cout << "------------------------" << std::endl;
 }
 
-void History::save(const std::string& filename, const std::string& rules, const bool& silent) const {
+void History::save(const std::string& filename, const std::string& rules, const bool& silent, const json& checkpoints) const {
 	std::string path = SAVE_DIR + filename + JSON_EXT;
 	std::ofstream ofs(path);
 	if (ofs.is_open()) {
@@ -71,9 +80,18 @@ void History::save(const std::string& filename, const std::string& rules, const
 		j[SAVE_RULES] = rules;
 		//store moves in turns in rounds
 		for (int i = 0; i < m_roundCount; ++i) {
-			j[SAVE_ROUND][std::to_string(i)][SAVE_WHITE_TURN] = m_history[i].white_turn;
-			j[SAVE_ROUND][std::to_string(i)][SAVE_BLACK_TURN] = m_history[i].black_turn;
+			json& round = j[SAVE_ROUND][std::to_string(i)];
+			round[SAVE_WHITE_TURN] = json::array();
+			round[SAVE_BLACK_TURN] = json::array();
+			for (uint32_t m = m_rounds[i].white; m < roundEnd(i); ++m) {
+				round[(m < m_rounds[i].black) ? SAVE_WHITE_TURN : SAVE_BLACK_TURN].push_back({ unpack(m_moves[m].current), unpack(m_moves[m].future) });
+			}
 		}
+		//store checkpoints and checksum
+		if (!checkpoints.is_null()) {
+			j[SAVE_CHECKPOINTS] = checkpoints;
+		}
+		j[SAVE_CHECKSUM] = checksum(j);
 		//store time
 		std::stringstream ss;
 		auto t = std::time(nullptr);
@@ -91,6 +109,19 @@ void History::save(const std::string& filename, const std::string& rules, const
 	}
 }
 
+std::string History::checksum(const json& file) {
+	uint64_t hash = 0xCBF29CE484222325ULL;	//FNV-1a offset basis
+	for (const std::string& key : { SAVE_RULES, SAVE_ROUND, SAVE_CHECKPOINTS }) {
+		std::string text = key + ((file.find(key) != file.end()) ? file.at(key).dump() : "");	//objects dump with sorted keys
+		for (const char& c : text) {
+			hash = (hash ^ (unsigned char)c) * 0x100000001B3ULL;	//FNV-1a prime
+		}
+	}
+	std::stringstream ss;
+	ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+	return ss.str();
+}
+
 void History::deleteSave(const std::string & filename, const bool& silent) const {
 	std::string path = SAVE_DIR + filename + JSON_EXT;
 	if (remove((path).c_str()) == 0) {
@@ -103,24 +134,32 @@ void History::deleteSave(const std::string & filename, const bool& silent) const
 }
 
 bool History::erase(int n) {
-	if (m_moveCount == 0) {
+	if (m_moveCount == 0 || n <= 0) {
 		return false;
 	}
-	for (int i = m_roundCount - 1; i >= 0;) {
-		if (n == 0) {	//nothing left to erase
-			break;
-		} else if (!m_history[i].black_turn.empty()) {	//first clear black's turn
-			m_history[i].black_turn.pop_back();
-			--m_moveCount;
-			--n;
-		} else if (!m_history[i].white_turn.empty()) {	//then white's
-			m_history[i].white_turn.pop_back();
-			--m_moveCount;
-			--n;			
-		} else if (m_history[i].white_turn.empty()) {	//white's turn is empty, so the round is empty
-			--m_roundCount;
-			--i;
-		}
+	uint32_t size = uint32_t(m_moves.size()) - uint32_t(std::min(n, m_moveCount));
+	m_moves.resize(size);
+	m_moveCount = int(size);
+	//the round holding the last move left is in progress again, so it is the one recordMove appends to
+	while (m_rounds.size() > 1 && m_rounds.back().white > size) {
+		m_rounds.pop_back();
 	}
+	m_rounds.back().black = std::min(m_rounds.back().black, size);
+	m_roundCount = int(m_rounds.size()) - ((m_rounds.back().white == m_rounds.back().black) ? 1 : 0);
 	return true;	//at least 1 move was erased
 }
+
+// Private
+// -------
+uint8_t History::pack(const std::string& pos) {
+	Square sq = toSquare(pos);
+	return (sq == NO_SQUARE) ? 0xFF : uint8_t(sq);
+}
+
+std::string History::unpack(const uint8_t& sq) {
+	return (sq == 0xFF) ? "??" : toAlgebraic(Square(sq));
+}
+
+uint32_t History::roundEnd(const size_t& i) const {
+	return (i + 1 < m_rounds.size()) ? m_rounds[i + 1].white : uint32_t(m_moves.size());
+}
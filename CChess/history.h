@@ -1,7 +1,8 @@
 #ifndef HISTORY_H
 #define HISTORY_H
 
-#include <deque>
+#include <vector>
+#include <cstdint>
 
 #include <nlohmann/json.hpp>
 // for convenience
@@ -32,14 +33,14 @@ public:
 	const int& moves();
 
 	/*
-		@brief		on the top Round of m_history, pushes back a vector of [current, future] onto the corresponding side's turn
+		@brief		appends a move to the turn of side in the last Round; within a round, White's moves come before Black's
 
 		@param		turn		enum of side whose turn it is
 		@param		current		inital position in move
 		@param		future		final position in move
 		@param		last		true if Black is making last move of turn - causes new Round to be prepared
 		
-		WARNING: History only records moves; it never checks their validity
+		WARNING: History only records moves; it never checks their validity (positions off the board are recorded as "??")
 	*/
 	void recordMove(const int& turn, const std::string& current, const std::string& future, const bool& last = false);
 
@@ -49,16 +50,25 @@ public:
 	void print() const;
 
 	/*
-		@brief		saves game history to file
+		@brief		saves game history to file, with a checksum of its contents
 
 		@param		filename	name of file (without extension) to save history to
 		@param		rules		name of rules that game is being played under
 		@param		silent		if true, won't print success message
+		@param		checkpoints	array of position snapshots to embed (see Game), or null for none
 	*/
-	void save(const std::string& filename, const std::string& rules, const bool& silent = false) const;
+	void save(const std::string& filename, const std::string& rules, const bool& silent = false, const json& checkpoints = json()) const;
 
 	/*
-		@brief		deletes file in save directory (for undo_temp)
+		@param		file		contents of a save file
+
+		@return		FNV-1a hash of the rules, rounds and checkpoints of file, as hex; a file whose SAVE_CHECKSUM
+					matches was saved as is, so its checkpoints and moves can be trusted
+	*/
+	static std::string checksum(const json& file);
+
+	/*
+		@brief		deletes file in save directory
 
 		@param		filename	name of save to be deleted (without extension)
 		@param		silent		if true, won't print success message
@@ -74,23 +84,60 @@ public:
 	
 private:
 	/*
-		@brief		every round starts with a White turn and ends with a Black turn,
-					regardless of how many moves (2 element vector of strings: [from, to]) occur
+		@brief		move packed into 2 bytes; squares off the board are stored as 0xFF
 	*/
-	struct Round {
+	struct PackedMove {
+		uint8_t current;
+		uint8_t future;
+	};
 
-		std::vector<std::vector<std::string>> white_turn;
-		std::vector<std::vector<std::string>> black_turn;
+	/*
+		@brief		every round starts with a White turn and ends with a Black turn, regardless of how many moves occur;
+					a round is where its turns start in m_moves: White's moves are [white, black) and Black's run up to
+					the start of the next round (or the end of m_moves for the last round)
+	*/
+	struct Round {
+		uint32_t white;
+		uint32_t black;
 	};
 
 	/*
-		@brief		history of moves, stored in Rounds by turn
+		@param		pos			position in algebraic notation
+
+		@return		pos packed into a byte
+	*/
+	static uint8_t pack(const std::string& pos);
+
+	/*
+		@param		sq			packed position
+
+		@return		sq in algebraic notation
+	*/
+	static std::string unpack(const uint8_t& sq);
+
+	/*
+		@param		i			index of round in m_rounds
+
+		@return		index in m_moves one past the last move of round i
+	*/
+	uint32_t roundEnd(const size_t& i) const;
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		every recorded move, in the order played; its capacity is kept by reset and erase,
+					so recording a move only allocates when a game grows longer than any before it
+	*/
+	std::vector<PackedMove> m_moves;
+
+	/*
+		@brief		boundaries of the rounds in m_moves; never empty, and the last is the round moves are recorded into
 	*/
-	std::deque<Round> m_history;
+	std::vector<Round> m_rounds;
 
 	/*
 		@brief		number of recorded/in-progress rounds
-					will differ from m_history.size() whenever black finishes a turn and white hasn't moved yet
+					will differ from m_rounds.size() whenever black finishes a turn and white hasn't moved yet
 	*/
 	int m_roundCount;
 
@@ -1,7 +1,74 @@
+#include <iostream>		// std::cout
+
 #include "game.h"
+#include "perft.h"
+#include "parallel_search.h"
+#include "validator.h"
+#include "game_record.h"
+#include "game_database.h"
+#include "protocol.h"
+#include "server.h"
 
 
-int main() {
-	Game g;
+int main(int argc, char* argv[]) {
+	std::vector<std::string> args(argv + 1, argv + argc);
+	if (!args.empty() && args[0] == PERFT) {	//headless move generation test
+		return Perft::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	if (!args.empty() && args[0] == SMP) {	//headless parallel search scaling test
+		return ParallelSearch::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	if (!args.empty() && args[0] == VALIDATE) {	//headless batch validation of save files
+		return Validator::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	if (!args.empty() && args[0] == CONVERT) {	//headless conversion between JSON saves and binary records
+		return GameRecord::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	if (!args.empty() && args[0] == DATABASE) {	//headless game database tool
+		return GameDatabase::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	if (!args.empty() && args[0] == ENGINE) {	//headless text protocol for other programs
+		return Protocol::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	if (!args.empty() && args[0] == SERVER) {	//headless multi-session game server over localhost TCP
+		return Server::run(std::vector<std::string>(args.begin() + 1, args.end()));
+	}
+	size_t hashMegabytes = TranspositionTable::DEFAULT_MEGABYTES;
+	bool hugePages = false;
+	int threads = 1;
+	int checkpointInterval = CHECKPOINT_INTERVAL;
+	bool trusted = false;
+	for (size_t i = 0; i < args.size(); ++i) {
+		if (args[i] == OPTION_HASH && i + 1 < args.size()) {
+			try {
+				hashMegabytes = std::stoul(args[++i]);
+			} catch (const std::exception&) {	//not a number, or out of range
+				std::cout << "Usage: " << OPTION_HASH << " <megabytes>" << std::endl;
+				return 1;
+			}
+		} else if (args[i] == OPTION_THREADS && i + 1 < args.size()) {
+			try {
+				threads = std::stoi(args[++i]);
+			} catch (const std::exception&) {
+				std::cout << "Usage: " << OPTION_THREADS << " <threads>" << std::endl;
+				return 1;
+			}
+		} else if (args[i] == OPTION_CHECKPOINTS && i + 1 < args.size()) {
+			try {
+				checkpointInterval = std::stoi(args[++i]);
+			} catch (const std::exception&) {
+				std::cout << "Usage: " << OPTION_CHECKPOINTS << " <moves>" << std::endl;
+				return 1;
+			}
+		} else if (args[i] == OPTION_TRUSTED) {
+			trusted = true;
+		} else if (args[i] == OPTION_HUGE_PAGES) {
+			hugePages = true;
+		} else {
+			std::cout << "Unrecognized option " << args[i] << std::endl;
+			return 1;
+		}
+	}
+	Game g(hashMegabytes, hugePages, threads, checkpointInterval, trusted);
 	g.play();
-}
\ No newline at end of file
+}
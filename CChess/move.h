@@ -0,0 +1,38 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include "square.h"
+
+
+/*
+	@brief		how a move was generated: which offsets of piece_library.json it came from
+*/
+enum MoveType {
+	MOVE_NORMAL = 0,	//"move" offsets onto an empty position
+	MOVE_CAPTURE = 1,	//"capture" offsets onto an enemy piece
+	MOVE_INITIAL = 2	//"initial" offsets, only available to a piece that has never moved
+};
+
+/*
+	@brief		outcome of checking a move without throwing (see Board::tryMove); only MOVE_OK means it can be played
+*/
+enum MoveStatus {
+	MOVE_OK = 0,
+	MOVE_CURRENT_OFF_BOARD,	//current could not be parsed, or is not on the board
+	MOVE_FUTURE_OFF_BOARD,	//same for future
+	MOVE_EMPTY_SQUARE,		//nothing stands on current
+	MOVE_WRONG_SIDE,		//piece on current belongs to the side not to move
+	MOVE_ILLEGAL,			//piece on current cannot reach future
+	MOVE_INTO_CHECK			//move would leave the royal piece of the mover in check
+};
+
+/*
+	@brief		single move of a piece from current to future
+*/
+struct Move {
+	Square current;
+	Square future;
+	MoveType type;
+};
+
+#endif MOVE_H
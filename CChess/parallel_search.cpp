@@ -0,0 +1,104 @@
+#include <iostream>		// std::cout
+#include <thread>		// std::thread
+#include <algorithm>	// std::max
+
+#include "constants.h"
+#include "parallel_search.h"
+
+
+// Public
+// ------
+ParallelSearch::ParallelSearch(const Board& board, TranspositionTable& tt, const int& threads)
+	: m_boards((threads > 1) ? threads : 1, board), m_tt(tt) {
+}
+
+SearchResult ParallelSearch::think(const int& milliseconds, const int& maxDepth, const bool& verbose) {
+	m_shared.stop = false;
+	for (std::atomic<int>& next : m_shared.nextRootMove) {
+		next = 0;
+	}
+	m_tt.newSearch();
+	m_results.assign(m_boards.size(), SearchResult());
+	std::vector<std::thread> helpers;
+	for (int thread = 1; thread < int(m_boards.size()); ++thread) {
+		helpers.emplace_back([this, thread, milliseconds, maxDepth]() {
+			Search search(m_boards[thread], m_tt);
+			search.join(&m_shared, thread);
+			m_results[thread] = search.think(milliseconds, maxDepth);
+		});
+	}
+	Search search(m_boards[0], m_tt);
+	search.join(&m_shared, 0);
+	m_results[0] = search.think(milliseconds, maxDepth, verbose);
+	m_shared.stop = true;	//main search is done: nothing the helpers find now would be used
+	for (std::thread& helper : helpers) {
+		helper.join();
+	}
+
+	SearchResult result = m_results[0];
+	for (const SearchResult& r : m_results) {
+		if (r.depth > result.depth) {	//a helper finished an iteration the main thread didn't
+			result.best = r.best;
+			result.score = r.score;
+			result.depth = r.depth;
+		}
+	}
+	result.nodes = 0;
+	for (const SearchResult& r : m_results) {
+		result.nodes += r.nodes;
+	}
+	return result;
+}
+
+const std::vector<SearchResult>& ParallelSearch::threadResults() const {
+	return m_results;
+}
+
+int ParallelSearch::run(const std::vector<std::string>& args) {
+	std::string rules = DEFAULT_RULES;
+	int depth = SMP_DEPTH;
+	int maxThreads = int(std::thread::hardware_concurrency());
+	try {
+		if (args.size() == 3) {
+			rules = args[0];
+			depth = std::stoi(args[1]);
+			maxThreads = std::stoi(args[2]);
+		} else if (!args.empty()) {
+			std::cout << "Usage: " << SMP << " [<rules> <depth> <threads>]" << std::endl;
+			return 1;
+		}
+		Board board;
+		board.reset(rules);
+		TranspositionTable tt;
+		double baseline = 0;
+		long long baselineNps = 0;
+		std::cout << "Threads\tTime\tNodes\t\tNPS\t\tSpeedup\tNPS x\tBest" << std::endl;
+		std::vector<int> counts;	//1, 2, 4... and finally maxThreads
+		for (int threads = 1; threads < maxThreads; threads *= 2) {
+			counts.push_back(threads);
+		}
+		counts.push_back(std::max(maxThreads, 1));
+		for (const int& threads : counts) {
+			tt.clear();	//every run starts cold, so times to depth are comparable
+			ParallelSearch search(board, tt, threads);
+			SearchResult result = search.think(0, depth);
+			long long nps = (long long)(result.nodes / (result.seconds > 0 ? result.seconds : 1e-9));
+			if (threads == 1) {
+				baseline = result.seconds;
+				baselineNps = nps;
+			}
+			std::cout << threads << '\t' << result.seconds << " s\t" << result.nodes << "\t\t" << nps << "\t\t"
+				<< baseline / (result.seconds > 0 ? result.seconds : 1e-9) << "\t" << double(nps) / (baselineNps ? baselineNps : 1) << "\t"
+				<< toAlgebraic(result.best.current) << '-' << toAlgebraic(result.best.future) << std::endl;
+			const std::vector<SearchResult>& perThread = search.threadResults();
+			for (int t = 0; t < int(perThread.size()); ++t) {
+				std::cout << "\tthread " << t << ": depth " << perThread[t].depth << ", "
+					<< (long long)(perThread[t].nodes / (perThread[t].seconds > 0 ? perThread[t].seconds : 1e-9)) << " nps" << std::endl;
+			}
+		}
+		return 0;
+	} catch (const std::invalid_argument& e) {	//unknown rules or a number that isn't one
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include "search.h"
+
+
+/*
+	@brief		Lazy SMP: runs a Search per thread, each on its own copy of the board, all sharing one transposition table
+				the main thread keeps time and decides when everything stops; helpers fill the table with results
+				from staggered depths and different root moves, which makes the main search faster
+*/
+class ParallelSearch {
+public:
+	/*
+		@param		board		position to search; copied once per thread, so it is never modified
+		@param		tt			transposition table shared by every thread
+		@param		threads		number of threads to search with, at least 1
+	*/
+	ParallelSearch(const Board& board, TranspositionTable& tt, const int& threads);
+
+	/*
+		@param		milliseconds	time budget; the best move found so far is returned once it runs out (0 for no limit)
+		@param		maxDepth		deepest iteration to start, at most Search::MAX_PLY
+		@param		verbose			if true, the main thread prints a line to standard output after every completed iteration
+
+		@return		best move from the thread that completed the deepest iteration (preferring the main thread),
+					with nodes summed over every thread
+	*/
+	SearchResult think(const int& milliseconds, const int& maxDepth = Search::MAX_PLY, const bool& verbose = false);
+
+	/*
+		@return		result of every thread from the last call to think, indexed by thread
+	*/
+	const std::vector<SearchResult>& threadResults() const;
+
+	/*
+		@brief		entry point of the headless smp mode, see main.cpp
+					smp [<rules> <depth> <threads>]		searches the initial board to depth with 1, 2, 4... up to threads threads
+														and prints nodes per second per thread and speedup against one thread
+
+		@param		args		command line arguments following "smp"
+
+		@return		process exit code
+	*/
+	static int run(const std::vector<std::string>& args);
+
+private:
+	// Member variables
+	// ----------------
+	/*
+		@brief		copy of the board for every thread
+	*/
+	std::vector<Board> m_boards;
+
+	/*
+		@brief		table shared by every thread
+	*/
+	TranspositionTable& m_tt;
+
+	/*
+		@brief		stop flag and root move counters shared by every thread
+	*/
+	Search::Shared m_shared;
+
+	/*
+		@brief		result of every thread from the last search
+	*/
+	std::vector<SearchResult> m_results;
+};
+
+#endif PARALLEL_SEARCH_H
@@ -0,0 +1,153 @@
+#include <iostream>		// std::cout
+#include <fstream>		// std::ifstream
+#include <chrono>		// std::chrono::steady_clock
+
+#include "constants.h"
+#include "perft.h"
+
+
+// Public
+// ------
+template <class G>
+BasicPerft<G>::BasicPerft(const std::string& rules) : m_rules_name(rules), m_board(rules) {
+}
+
+template <class G>
+BasicPerft<G>::BasicPerft(const BasicBoard<G>& board) : m_board(board) {
+}
+
+template <class G>
+long long BasicPerft<G>::count(const int& depth) {
+	return count(m_board.turn(), depth);
+}
+
+template <class G>
+long long BasicPerft<G>::divide(const int& depth) {
+	auto start = std::chrono::steady_clock::now();
+	long long total = 0;
+	int side = m_board.turn();
+	for (const Move& m : m_board.generateLegalMoves(side)) {
+		typename BasicBoard<G>::Undo undo = m_board.makeMove(m.current, m.future);
+		long long nodes = (depth > 1) ? count(!side, depth - 1) : 1;
+		m_board.unmakeMove(undo);
+		std::cout << G::toAlgebraic(m.current, FIRST_COL, FIRST_ROW) << '-' << G::toAlgebraic(m.future, FIRST_COL, FIRST_ROW) << ":\t" << nodes << std::endl;
+		total += nodes;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << std::endl << "Nodes:\t" << total << std::endl
+		<< "Time:\t" << seconds << " s" << std::endl
+		<< "NPS:\t" << (long long)(total / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+	return total;
+}
+
+template <class G>
+int BasicPerft<G>::run(const std::vector<std::string>& args) {
+	//reference counts, by rules name then depth - 1
+	json reference;
+	try {
+		std::ifstream ifs(RULES_DIR + PERFT + JSON_EXT);
+		if (ifs.is_open()) {
+			reference = json::parse(ifs);
+		}
+		bool passed = true;
+		if (args.empty()) {	//check every ruleset against every reference depth
+			for (const std::string& rules : Board().listRules()) {
+				if (reference.find(rules) == reference.end()) {
+					std::cout << rules << "\tno reference counts" << std::endl;
+					continue;
+				}
+				passed &= withRules(rules, [&](auto& perft) {
+					bool matched = true;
+					for (int depth = 1; depth <= int(reference[rules].size()); ++depth) {
+						matched &= perft.report(depth, reference[rules][depth - 1].get<long long>());
+					}
+					return matched;
+				});
+			}
+		} else if (args.size() == 2 && args[0] == PERFT_ALL) {	//totals for every ruleset at one depth
+			int depth = positiveDepth(args[1]);
+			for (const std::string& rules : Board().listRules()) {
+				long long expected = -1;
+				if (reference.find(rules) != reference.end() && depth <= int(reference[rules].size())) {
+					expected = reference[rules][depth - 1].get<long long>();
+				}
+				passed &= withRules(rules, [&](auto& perft) { return perft.report(depth, expected); });
+			}
+		} else if (args.size() == 2) {	//breakdown by root move for one ruleset
+			int depth = positiveDepth(args[1]);
+			withRules(args[0], [&](auto& perft) {
+				perft.divide(depth);
+				return true;
+			});
+		} else {
+			std::cout << "Usage: perft [<rules>|" << PERFT_ALL << " <depth>]" << std::endl;
+			return 1;
+		}
+		return passed ? 0 : 1;
+	} catch (const std::exception& e) {	//unknown rules, depth out of range, or a perft.json that isn't valid
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
+
+// Private
+// -------
+template <class G>
+template <class F>
+bool BasicPerft<G>::withRules(const std::string& rules, F f) {
+	return withGeometry(RulesRegistry::get()->rules().getRules(rules).size, [&](auto geometry) {
+		BasicPerft<decltype(geometry)> perft(rules);
+		return f(perft);
+	});
+}
+
+template <class G>
+long long BasicPerft<G>::count(const int& side, const int& depth) {
+	if (depth <= 0) {	//also ends the recursion for a negative depth
+		return 1;
+	}
+	std::vector<Move> moves = m_board.generateLegalMoves(side);
+	if (depth == 1) {	//leaves don't need to be made
+		return moves.size();
+	}
+	long long nodes = 0;
+	for (const Move& m : moves) {
+		typename BasicBoard<G>::Undo undo = m_board.makeMove(m.current, m.future);
+		nodes += count(!side, depth - 1);
+		m_board.unmakeMove(undo);
+	}
+	return nodes;
+}
+
+template <class G>
+int BasicPerft<G>::positiveDepth(const std::string& text) {
+	int depth = std::stoi(text);
+	if (depth < 1) {
+		throw std::invalid_argument("Depth must be at least 1.");
+	}
+	return depth;
+}
+
+template <class G>
+bool BasicPerft<G>::report(const int& depth, const long long& reference) {
+	auto start = std::chrono::steady_clock::now();
+	long long nodes = count(depth);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << m_rules_name << "\tdepth " << depth << '\t' << nodes << " nodes\t"
+		<< seconds << " s\t" << (long long)(nodes / (seconds > 0 ? seconds : 1e-9)) << " nps";
+	bool passed = (reference < 0 || nodes == reference);
+	if (reference < 0) {
+		std::cout << "\tno reference count" << std::endl;
+	} else if (passed) {
+		std::cout << "\tOK" << std::endl;
+	} else {
+		std::cout << "\tFAILED (expected " << reference << ")" << std::endl;
+	}
+	return passed;
+}
+
+// Instantiations
+// --------------
+template class BasicPerft<Geometry<8>>;
+template class BasicPerft<Geometry<10>>;
+template class BasicPerft<Geometry<12>>;
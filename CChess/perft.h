@@ -0,0 +1,113 @@
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "board.h"
+
+
+/*
+	@brief		counts leaf positions on a board of geometry G, to check move generation against known counts
+*/
+template <class G>
+class BasicPerft {
+public:
+	/*
+		@brief		sets up a board under rules, with White to move
+
+		@param		rules		name of rules object in ruleset.json, for a board of geometry G
+
+		@throw		invalid_argument if rules do not exist or are for a board of another size
+	*/
+	BasicPerft(const std::string& rules);
+
+	/*
+		@brief		counts from a copy of board, with its side to move
+
+		@param		board		position to count from
+	*/
+	BasicPerft(const BasicBoard<G>& board);
+
+	/*
+		@param		depth		number of plies to search
+
+		@return		number of leaf positions reachable from the board in exactly depth legal moves (1 if depth <= 0)
+	*/
+	long long count(const int& depth);
+
+	/*
+		@brief		prints the leaf count below every legal root move, followed by the total and nodes per second
+
+		@param		depth		number of plies to search (including the root move)
+
+		@return		total number of leaf positions
+	*/
+	long long divide(const int& depth);
+
+	/*
+		@brief		entry point of the headless perft mode, see main.cpp
+					perft							checks every ruleset against the reference counts in perft.json
+					perft <rules|all> <depth>		prints a divide breakdown (rules) or totals for every ruleset (all)
+					each ruleset is counted on a board of its own size, whatever G is
+
+		@param		args		command line arguments following "perft"
+
+		@return		process exit code: 0 if every count matched its reference
+	*/
+	static int run(const std::vector<std::string>& args);
+
+private:
+	template <class> friend class BasicPerft;
+
+	/*
+		@brief		sets up a BasicPerft under rules, on a board of the size the rules are for
+
+		@param		rules		name of rules object in ruleset.json
+		@param		f			callable taking a BasicPerft of any geometry by reference
+
+		@return		what f returns
+
+		@throw		invalid_argument if rules do not exist or can't be used
+	*/
+	template <class F>
+	static bool withRules(const std::string& rules, F f);
+
+	/*
+		@param		side		side to move
+		@param		depth		remaining plies
+
+		@return		number of leaf positions below the current board (1 if depth <= 0)
+	*/
+	long long count(const int& side, const int& depth);
+
+	/*
+		@param		text		depth given on the command line
+
+		@return		depth of text
+
+		@throw		invalid_argument if text is not a number or is less than 1 (out_of_range if it doesn't fit an int)
+	*/
+	static int positiveDepth(const std::string& text);
+
+	/*
+		@param		depth		number of plies to search
+		@param		reference	expected leaf count, or a negative number if there is none
+
+		@return		true if the count matched reference (or there was nothing to check against)
+	*/
+	bool report(const int& depth, const long long& reference);
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		name of rules object the board was set up with
+	*/
+	std::string m_rules_name;
+
+	/*
+		@brief		board moves are made and unmade on
+	*/
+	BasicBoard<G> m_board;
+};
+
+typedef BasicPerft<BoardGeometry> Perft;
+
+#endif PERFT_H
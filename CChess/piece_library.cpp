@@ -1,23 +1,54 @@
 #include <fstream>      // std::ifstream
+#include <algorithm>	// std::fill, std::transform
 
 #include "constants.h"
 #include "piece_library.h"
 
 
+const int PieceLibrary::NO_PIECE;
+
+
 // Public
 // ------
 PieceLibrary::PieceLibrary() {
+	std::fill(m_index, m_index + 128, NO_PIECE);
 	//load piece library from json
 	std::ifstream ifs(RULES_DIR + PIECES_LIBRARY + JSON_EXT);
-	m_library = json::parse(ifs);
+	json library = json::parse(ifs);
+	//compile every piece once so json is never consulted again
+	for (const auto& p : library.get<json::object_t>()) {
+		if (p.first.size() != 1 || (unsigned char)p.first[0] >= 128) {	//m_index only covers ASCII
+			throw std::invalid_argument("Piece \"" + p.first + "\" in " + PIECES_LIBRARY + JSON_EXT + " must be a single ASCII char.");
+		}
+		Entry entry;
+		entry.piece = toupper(p.first[0]);
+		entry.name = p.second[PIECE_NAME].get<std::string>();
+		for (int kind = 0; kind < OFFSET_KINDS; ++kind) {
+			compileOffsets(p.second, OffsetKind(kind), entry);
+		}
+		m_index[toupper(entry.piece)] = m_index[tolower(entry.piece)] = int(m_entries.size());
+		m_entries.push_back(entry);
+	}
 }
 
 bool PieceLibrary::contains(const char & piece) const {
-	return !getRules(piece).empty();
+	return indexOf(piece) != NO_PIECE;
+}
+
+int PieceLibrary::indexOf(const char& piece) const {
+	return (piece >= 0) ? m_index[(unsigned char)piece] : NO_PIECE;	//char may be signed
+}
+
+int PieceLibrary::size() const {
+	return int(m_entries.size());
+}
+
+char PieceLibrary::getPiece(const int& index) const {
+	return m_entries[index].piece;
 }
 
 const std::string PieceLibrary::getName(const char& piece, bool capitalization) const {
-	std::string name = getRules(piece)[PIECE_NAME].get<std::string>();
+	std::string name = m_entries[indexOf(piece)].name;
 	if (capitalization) {
 		if (whichSide(piece) == WHITE) {
 			std::transform(name.begin(), name.end(), name.begin(), ::toupper);
@@ -28,17 +59,45 @@ const std::string PieceLibrary::getName(const char& piece, bool capitalization)
 	return name;
 }
 
-const std::vector<std::vector<int>> PieceLibrary::getOffsets(const char & piece, const std::string& offsetKey) const {
-	if (getRules(piece)[offsetKey].is_string()) {	//e.g. capture is the same as "move" rather than an explicit array
-		//forgive my syntax, for i have sinned
-		return getRules(piece)[getRules(piece)[offsetKey].get<std::string>()].get<std::vector<std::vector<int>>>();
-	} else {
-		return getRules(piece)[offsetKey].get<std::vector<std::vector<int>>>();
-	}
+OffsetRange PieceLibrary::getOffsets(const char & piece, const OffsetKind& kind) const {
+	const Entry& entry = m_entries[indexOf(piece)];
+	const Offset* offsets = m_offsets.data();
+	return { offsets + entry.begin[kind], offsets + entry.end[kind] };
 }
 
 // Private
 // -------
-const json& PieceLibrary::getRules(const char& piece) const {
-	return m_library[std::string(1, toupper(piece))];
-}
\ No newline at end of file
+void PieceLibrary::compileOffsets(const json& rules, const OffsetKind& kind, Entry& entry) {
+	static const std::string keys[OFFSET_KINDS] = { PIECE_INITIAL_ARRAY, PIECE_MOVE_ARRAY, PIECE_CAPTURE_ARRAY };
+	entry.begin[kind] = entry.end[kind] = int(m_offsets.size());
+	if (rules.find(keys[kind]) == rules.end()) {	//missing array has no offsets
+		return;
+	}
+	const json* offsets = &rules[keys[kind]];
+	if (offsets->is_string()) {	//e.g. capture is the same as "move" rather than an explicit array
+		std::string alias = offsets->get<std::string>();
+		auto aliased = rules.find(alias);	//never operator[], which would insert a null array into the json
+		if (aliased == rules.end() || aliased->is_string()) {	//only one level of aliases is resolved
+			throw std::invalid_argument(entry.name + " has " + keys[kind] + " \"" + alias + "\", which is not an offset array, in "
+				+ PIECES_LIBRARY + JSON_EXT + ".");
+		}
+		offsets = &*aliased;
+	}
+	for (const auto& o : offsets->get<std::vector<std::vector<int>>>()) {
+		if (o.size() < JSON_RANGE_INDEX || o.size() > JSON_RANGE_INDEX + 1) {
+			throw std::invalid_argument(entry.name + " has a malformed offset in " + PIECES_LIBRARY + JSON_EXT + ".");
+		}
+		Offset compiled;
+		compiled.forward = o[0];
+		compiled.right = o[1];
+		if (o.size() == JSON_RANGE_INDEX) {	//single offset
+			compiled.range = 1;
+		} else if (o[JSON_RANGE_INDEX] == JSON_RANGE_INFINITE) {	//can travel at most the length of the largest board
+			compiled.range = MAX_BOARD_SIZE - 1;
+		} else {
+			compiled.range = o[JSON_RANGE_INDEX];
+		}
+		m_offsets.push_back(compiled);
+	}
+	entry.end[kind] = int(m_offsets.size());
+}
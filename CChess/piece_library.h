@@ -1,15 +1,51 @@
 #ifndef PIECE_LIBRARY_H
 #define PIECE_LIBRARY_H
 
+#include <vector>
+
 #include <nlohmann/json.hpp>
 // for convenience
 using json = nlohmann::json;
 
 
+/*
+	@brief		kinds of offset arrays a piece can have in piece_library.json
+*/
+enum OffsetKind {
+	OFFSET_INITIAL = 0,
+	OFFSET_MOVE = 1,
+	OFFSET_CAPTURE = 2,
+	OFFSET_KINDS = 3
+};
+
+/*
+	@brief		single compiled offset from piece_library.json
+*/
+struct Offset {
+	int forward;	//offset in forward direction (negative is backwards)
+	int right;		//offset in right direction (negative is left)
+	int range;		//number of times the offset can be repeated (1 unless a range is given in the json)
+};
+
+/*
+	@brief		view of a contiguous run of offsets, usable in range-based for loops
+*/
+struct OffsetRange {
+	const Offset* first;
+	const Offset* last;
+
+	const Offset* begin() const { return first; }
+	const Offset* end() const { return last; }
+	bool empty() const { return first == last; }
+};
+
+
 class PieceLibrary {
 public:
 	/*
-		@brief		loads json where pieces are stored
+		@brief		loads json where pieces are stored and compiles it into offset tables
+
+		@throw		std::invalid_argument if a piece, offset or alias is malformed
 	*/
 	PieceLibrary();
 
@@ -20,6 +56,24 @@ public:
 	*/
 	bool contains(const char& piece) const;
 
+	/*
+		@param		piece		char of piece (case unimportant)
+
+		@return		small index of piece into the compiled tables, or NO_PIECE if not in the json
+	*/
+	int indexOf(const char& piece) const;
+
+	/*
+		@return		number of pieces in the library
+	*/
+	int size() const;
+
+	/*
+		@param		index		index of piece, from 0 to size() - 1
+
+		@return		char of piece as written in the json (uppercase, i.e. White)
+	*/
+	char getPiece(const int& index) const;
 
 	/*
 		@param		piece			char of piece (case unimportant)
@@ -30,31 +84,55 @@ public:
 	const std::string getName(const char& piece, bool capitalization = true) const;
 
 	/*
-		@param		piece		char of piece (case unimportant)
-		@param		offsetKey	type of offsets, e.g. move or capture
+		@param		piece		char of piece (case unimportant); must be contained in the library
+		@param		kind		type of offsets, e.g. move or capture
 
-		@return		vector of offsets of type offsetKey
+		@return		view of offsets of type kind (aliases such as "capture": "move" are already resolved)
 	*/
-	const std::vector<std::vector<int>> getOffsets(const char& piece, const std::string& offsetKey) const;
+	OffsetRange getOffsets(const char& piece, const OffsetKind& kind) const;
+
+	static const int NO_PIECE = -1;
 
 private:
 	/*
-		@brief		Used for all public functions to shorten syntax
+		@brief		compiled form of a single piece; offsets of each kind are [begin, end) in m_offsets
+	*/
+	struct Entry {
+		char piece;
+		std::string name;
+		int begin[OFFSET_KINDS];
+		int end[OFFSET_KINDS];
+	};
+
+	/*
+		@brief		appends one offset array (or string alias to another array) of a piece from the json to m_offsets
 
 
-		@param		piece		char of piece
+		@param		rules		json object of a single piece
+		@param		kind		type of offsets to compile
+		@param		entry		compiled piece that receives the [begin, end) of the new offsets
 
-		@return		json on rules pertaining to piece at pos (cannot be modified)
+		@throw		std::invalid_argument if an offset is malformed, or an alias does not name an offset array of the piece
 	*/
-	const json& getRules(const char& piece) const;
+	void compileOffsets(const json& rules, const OffsetKind& kind, Entry& entry);
 
 
 	// Member variables
 	// ----------------
 	/*
-		@brief		json loaded from file containing piece rules
+		@brief		compiled pieces, indexed by m_index
+	*/
+	std::vector<Entry> m_entries;
+
+	/*
+		@brief		offsets of every piece, stored contiguously
+	*/
+	std::vector<Offset> m_offsets;
+
+	/*
+		@brief		index into m_entries for every char (both cases), NO_PIECE if char is not a piece
 	*/
-	json m_library;
+	int m_index[128];
 };
 
 #endif PIECE_LIBRARY_H
@@ -0,0 +1,184 @@
+#include <chrono>		// std::chrono::steady_clock
+#include <cctype>		// isalpha
+
+#include "constants.h"
+#include "protocol.h"
+#include "parallel_search.h"
+#include "perft.h"
+
+
+// Public
+// ------
+Protocol::Protocol(std::ostream& out, const size_t& hashMegabytes, const int& threads)
+	: m_out(out), m_board(), m_tt(hashMegabytes), m_threads((threads > 1) ? threads : 1) {
+}
+
+bool Protocol::execute(const std::string& line) {
+	std::istringstream in(line);
+	std::string command;
+	if (!(in >> command)) {	//blank line
+		return true;
+	}
+	try {
+		if (command == ENGINE_UCI) {
+			m_out << "id name CChess" << '\n' << "uciok" << std::endl;
+		} else if (command == ENGINE_ISREADY) {
+			m_out << "readyok" << std::endl;
+		} else if (command == ENGINE_NEWGAME) {
+			m_tt.clear();
+			m_board.reset();
+		} else if (command == ENGINE_POSITION) {
+			position(in);
+		} else if (command == ENGINE_GO) {
+			go(in);
+		} else if (command == ENGINE_PERFT) {
+			perft(in);
+		} else if (command == ENGINE_BENCH) {
+			bench();
+		} else if (command == ENGINE_QUIT) {
+			return false;
+		} else {
+			throw std::invalid_argument("Unknown command " + command);
+		}
+	} catch (const std::invalid_argument& e) {
+		m_out << "error " << e.what() << std::endl;
+	}
+	return true;
+}
+
+int Protocol::run(const std::vector<std::string>& args) {
+	try {
+		if (args.size() > 2) {
+			throw std::invalid_argument("Usage: " + ENGINE + " [<threads> [<megabytes>]]");
+		}
+		int threads = (args.size() > 0) ? std::stoi(args[0]) : 1;
+		size_t megabytes = (args.size() > 1) ? std::stoul(args[1]) : TranspositionTable::DEFAULT_MEGABYTES;
+		std::ios::sync_with_stdio(false);	//replies are flushed per command, not per character
+		Protocol protocol(std::cout, megabytes, threads);
+		std::string line;
+		while (std::getline(std::cin, line) && protocol.execute(line)) {
+		}
+		return 0;
+	} catch (const std::exception& e) {	//bad arguments, or rules that can't be loaded
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
+
+Move Protocol::parseMove(const std::string& text) {
+	std::string move;
+	for (const char& c : text) {
+		if (c != '-') {
+			move += c;
+		}
+	}
+	size_t split = 1;	//the future square starts at the first letter after the current square's column
+	while (split < move.size() && !isalpha((unsigned char)move[split])) {
+		++split;
+	}
+	Move m = { toSquare(move.substr(0, split)), (split < move.size()) ? toSquare(move.substr(split)) : NO_SQUARE, MOVE_NORMAL };
+	if (m.current == NO_SQUARE || m.future == NO_SQUARE) {
+		throw std::invalid_argument("Malformed move " + text);
+	}
+	return m;
+}
+
+// Private
+// -------
+void Protocol::position(std::istringstream& in) {
+	std::string rules, word;
+	if (!(in >> rules)) {
+		throw std::invalid_argument("Usage: " + ENGINE_POSITION + " <rules> [" + ENGINE_MOVES + " <move>...]");
+	}
+	Board board = m_board;	//only replaces m_board if every move is legal
+	board.reset(rules);
+	if (in >> word) {
+		if (word != ENGINE_MOVES) {
+			throw std::invalid_argument("Expected " + ENGINE_MOVES + " after rules, not " + word);
+		}
+		while (in >> word) {
+			Move m = parseMove(word);
+			MoveStatus status = board.tryMove(m.current, m.future, board.turn());
+			if (status != MOVE_OK) {
+				throw std::invalid_argument(word + ": " + board.describe(status, m.current));
+			}
+		}
+	}
+	m_board = board;
+}
+
+void Protocol::go(std::istringstream& in) {
+	int milliseconds = 0, depth = Search::MAX_PLY;
+	bool limited = false;
+	std::string word;
+	while (in >> word) {
+		if (word == ENGINE_MOVETIME) {
+			milliseconds = number(in);
+			if (milliseconds <= 0) {	//think() treats 0 as no time limit
+				throw std::invalid_argument("Movetime must be positive.");
+			}
+		} else if (word == ENGINE_DEPTH) {
+			depth = number(in);
+			if (depth <= 0) {
+				throw std::invalid_argument("Depth must be positive.");
+			}
+		} else {
+			throw std::invalid_argument("Unknown argument " + word + " of " + ENGINE_GO);
+		}
+		limited = true;
+	}
+	if (!limited) {
+		milliseconds = Search::DEFAULT_MILLISECONDS;
+	}
+	SearchResult result = ParallelSearch(m_board, m_tt, m_threads).think(milliseconds, depth);
+	int ms = int(result.seconds * 1000);
+	m_out << "info depth " << result.depth << " score " << result.score << " nodes " << result.nodes << " time " << ms
+		<< " nps " << (long long)(result.nodes / (result.seconds > 0 ? result.seconds : 1e-9)) << " hashfull " << m_tt.hashfull() << '\n';
+	if (result.best.current == NO_SQUARE) {
+		m_out << "bestmove none" << std::endl;
+	} else {
+		m_out << "bestmove " << toAlgebraic(result.best.current) << toAlgebraic(result.best.future) << std::endl;
+	}
+}
+
+void Protocol::perft(std::istringstream& in) {
+	int depth = number(in);
+	if (depth < 0) {
+		throw std::invalid_argument("Depth must not be negative.");
+	}
+	auto start = std::chrono::steady_clock::now();
+	long long nodes = Perft(m_board).count(depth);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	m_out << "perft " << depth << " nodes " << nodes << " time " << int(seconds * 1000)
+		<< " nps " << (long long)(nodes / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+}
+
+void Protocol::bench() {
+	long long nodes = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (const std::string& rules : m_board.listRules()) {
+		Board board;
+		try {
+			board.reset(rules);
+		} catch (const std::invalid_argument& e) {	//rules that can't be used aren't benchmarked
+			m_out << "info " << rules << " skipped: " << e.what() << '\n';
+			continue;
+		}
+		long long counted = Perft(board).count(BENCH_PERFT_DEPTH);
+		TranspositionTable tt(1);	//same small table every time, so the node count only changes with the search
+		SearchResult result = Search(board, tt).think(0, BENCH_SEARCH_DEPTH);
+		m_out << "info " << rules << " perft " << counted << " search " << result.nodes << '\n';
+		nodes += counted + result.nodes;
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	m_out << "bench nodes " << nodes << " time " << int(seconds * 1000)
+		<< " nps " << (long long)(nodes / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+}
+
+int Protocol::number(std::istringstream& in) {
+	int n;
+	if (!(in >> n)) {
+		throw std::invalid_argument("Expected a number.");
+	}
+	return n;
+}
@@ -0,0 +1,118 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <iostream>
+#include <sstream>
+
+#include "board.h"
+#include "transposition_table.h"
+
+
+/*
+	@brief		line-oriented text protocol in the style of UCI, for driving the engine from other programs
+				one command per line; every reply is one or more whole lines, and errors are reported as "error <reason>"
+
+				uci									replies "id name CChess" and "uciok"
+				isready								replies "readyok"
+				newgame								clears the transposition table and resets the board
+				position <rules> [moves <m>...]		sets up rules and plays moves such as e2e4 (or e2-e4) from the initial board
+				go [movetime <ms>] [depth <n>]		searches the position; replies "info ..." then "bestmove <m>" (or "bestmove none")
+				perft <n>							replies "perft <n> nodes <count> time <ms> nps <nps>"
+				bench								counts and searches the initial board of every ruleset to fixed depths
+				quit								ends the session
+*/
+class Protocol {
+public:
+	/*
+		@param		out				stream replies are written to
+		@param		hashMegabytes	size of the transposition table of the session
+		@param		threads			number of threads go searches with
+	*/
+	Protocol(std::ostream& out, const size_t& hashMegabytes = TranspositionTable::DEFAULT_MEGABYTES, const int& threads = 1);
+
+	/*
+		@param		line		one command
+
+		@return		false once the session is over (quit)
+	*/
+	bool execute(const std::string& line);
+
+	/*
+		@brief		entry point of the headless engine mode, see main.cpp
+					engine [<threads> [<megabytes>]]		executes commands from standard input until quit or end of input
+
+		@param		args		command line arguments following "engine"
+
+		@return		process exit code
+	*/
+	static int run(const std::vector<std::string>& args);
+
+	/*
+		@param		text		move in coordinate notation, e.g. e2e4 or e2-e4
+
+		@return		move with current and future squares (type is not filled in)
+
+		@throw		invalid_argument if text is not two squares of the board
+	*/
+	static Move parseMove(const std::string& text);
+
+private:
+	/*
+		@param		in			arguments of the position command
+
+		@throw		invalid_argument if the rules don't exist or a move is malformed or illegal (the position is unchanged)
+	*/
+	void position(std::istringstream& in);
+
+	/*
+		@param		in			arguments of the go command
+
+		@throw		invalid_argument if an argument is malformed, or movetime or depth is not positive
+	*/
+	void go(std::istringstream& in);
+
+	/*
+		@param		in			arguments of the perft command
+
+		@throw		invalid_argument if the depth is missing, malformed or negative
+	*/
+	void perft(std::istringstream& in);
+
+	/*
+		@brief		counts every ruleset to BENCH_PERFT_DEPTH and searches it to BENCH_SEARCH_DEPTH, and replies with totals
+	*/
+	void bench();
+
+	/*
+		@param		in			stream positioned before a number
+
+		@return		the number
+
+		@throw		invalid_argument if there is no number
+	*/
+	static int number(std::istringstream& in);
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		stream replies are written to
+	*/
+	std::ostream& m_out;
+
+	/*
+		@brief		position set by the last position command
+	*/
+	Board m_board;
+
+	/*
+		@brief		transposition table kept between searches of the session
+	*/
+	TranspositionTable m_tt;
+
+	/*
+		@brief		number of threads go searches with
+	*/
+	int m_threads;
+};
+
+#endif PROTOCOL_H
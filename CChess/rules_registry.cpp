@@ -0,0 +1,49 @@
+#include <mutex>		// std::mutex, std::lock_guard
+
+#include "rules_registry.h"
+
+
+// Public
+// ------
+template <class G>
+std::shared_ptr<const BasicRulesRegistry<G>> BasicRulesRegistry<G>::get() {
+	static std::mutex mutex;
+	static std::shared_ptr<const BasicRulesRegistry> registry;	//kept for the whole process, so boards made later share it too
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!registry) {
+		registry.reset(new BasicRulesRegistry());
+	}
+	return registry;
+}
+
+template <class G>
+const PieceLibrary& BasicRulesRegistry<G>::pieces() const {
+	return m_plib;
+}
+
+template <class G>
+const BasicAttackTable<G>& BasicRulesRegistry<G>::attacks() const {
+	return m_attacks;
+}
+
+template <class G>
+const BasicZobrist<G>& BasicRulesRegistry<G>::zobrist() const {
+	return m_zobrist;
+}
+
+template <class G>
+const Ruleset& BasicRulesRegistry<G>::rules() const {
+	return m_rules;
+}
+
+// Private
+// -------
+template <class G>
+BasicRulesRegistry<G>::BasicRulesRegistry() : m_plib(), m_attacks(m_plib), m_zobrist(m_plib.size()), m_rules() {
+}
+
+// Instantiations
+// --------------
+template class BasicRulesRegistry<Geometry<8>>;
+template class BasicRulesRegistry<Geometry<10>>;
+template class BasicRulesRegistry<Geometry<12>>;
@@ -0,0 +1,76 @@
+#ifndef RULES_REGISTRY_H
+#define RULES_REGISTRY_H
+
+#include <memory>
+
+#include "piece_library.h"
+#include "attack_table.h"
+#include "zobrist.h"
+#include "ruleset.h"
+
+
+/*
+	@brief		everything compiled from the rules files for boards of geometry G: pieces, their attack tables, hash keys
+				and rules objects
+				loaded once per process and never modified, so every Board (and every copy of one, such as the boards of
+				search threads) shares one registry through a reference-counted pointer instead of parsing its own
+*/
+template <class G>
+class BasicRulesRegistry {
+public:
+	/*
+		@return		registry of this process for geometry G, loaded on first use (thread safe)
+
+		@throw		std::invalid_argument if the piece library is malformed (the next call tries again)
+	*/
+	static std::shared_ptr<const BasicRulesRegistry> get();
+
+	BasicRulesRegistry(const BasicRulesRegistry&) = delete;
+	BasicRulesRegistry& operator=(const BasicRulesRegistry&) = delete;
+
+	/*
+		@return		library of piece rules
+	*/
+	const PieceLibrary& pieces() const;
+
+	/*
+		@return		attack masks precomputed from pieces()
+	*/
+	const BasicAttackTable<G>& attacks() const;
+
+	/*
+		@return		hash keys sized for pieces()
+	*/
+	const BasicZobrist<G>& zobrist() const;
+
+	/*
+		@return		every rules object for initial board and royal piece (including those for boards of other sizes)
+	*/
+	const Ruleset& rules() const;
+
+private:
+	/*
+		@brief		loads and compiles the rules files
+	*/
+	BasicRulesRegistry();
+
+	// Member variables
+	// ----------------
+	PieceLibrary m_plib;
+
+	/*
+		@brief		must be declared after m_plib
+	*/
+	BasicAttackTable<G> m_attacks;
+
+	/*
+		@brief		must be declared after m_plib
+	*/
+	BasicZobrist<G> m_zobrist;
+
+	Ruleset m_rules;
+};
+
+typedef BasicRulesRegistry<BoardGeometry> RulesRegistry;
+
+#endif RULES_REGISTRY_H
@@ -1,34 +1,82 @@
 #include <fstream>      // std::ifstream
+#include <set>			// std::set
 
 #include "constants.h"
+#include "square.h"
 #include "ruleset.h"
 
-Ruleset::Ruleset(const std::string& rules_name) : m_rules_name(rules_name) {
+
+// Public
+// ------
+
+Ruleset::Ruleset() {
 	//load ruleset from json
 	std::ifstream ifs(RULES_DIR + RULESET + JSON_EXT);
-	m_ruleset = json::parse(ifs);
+	json ruleset = json::parse(ifs);
+	for (const auto& r : ruleset.get<json::object_t>()) {
+		try {
+			m_compiled[r.first] = compile(r.second);
+		} catch (const std::invalid_argument& e) {	//only an error if these rules are selected
+			m_errors[r.first] = e.what();
+		}
+	}
 }
 
-void Ruleset::setRules(const std::string& name) {
-	if (m_ruleset.find(name) != m_ruleset.end()) {
-		m_rules_name = name;
-	} else {
-		throw std::invalid_argument("Rules do no exist. Try again.");
+const CompiledRules& Ruleset::getRules(const std::string& name) const {
+	auto compiled = m_compiled.find(name);
+	if (compiled != m_compiled.end()) {
+		return compiled->second;
 	}
-	
+	auto error = m_errors.find(name);
+	throw std::invalid_argument((error != m_errors.end()) ? error->second : "Rules do no exist. Try again.");
 }
 
-const char Ruleset::getInitialBoardAt(const int& row, const int& col) const {
-	return m_ruleset[m_rules_name][RULES_BOARD][row][col].get<std::string>()[0];
+void Ruleset::printAll() const {
+	for (const std::string& name : getNames()) {
+		std::cout << "> " << name << std::endl;
+	}
 }
 
-const char Ruleset::getRoyal(const int& side) const {
-	if (side == WHITE) return toupper(m_ruleset[m_rules_name][RULES_ROYAL].get<std::string>()[0]);
-	else return tolower(m_ruleset[m_rules_name][RULES_ROYAL].get<std::string>()[0]);
+std::vector<std::string> Ruleset::getNames() const {
+	std::set<std::string> names;	//sorted like the json object they came from
+	for (const auto& r : m_compiled) {
+		names.insert(r.first);
+	}
+	for (const auto& r : m_errors) {
+		names.insert(r.first);
+	}
+	return std::vector<std::string>(names.begin(), names.end());
 }
 
-void Ruleset::printAll() const {
-	for (const auto& r : m_ruleset.get<json::object_t>()) {
-		std::cout << "> " << r.first << std::endl;	//retrieve first field of object (rule names)
+// Private
+// -------
+CompiledRules Ruleset::compile(const json& rules) {
+	CompiledRules compiled;
+	try {
+		const json& board = rules.at(RULES_BOARD);
+		compiled.size = int(board.size());
+		if (!isBoardSize(compiled.size)) {	//boards are only built for a few sizes
+			throw std::invalid_argument("Rules are for a " + std::to_string(board.size()) + "x" + std::to_string(board.at(0).size())
+				+ " board, which is not supported. Rules cannot be used.");
+		}
+		for (int row = 0; row < compiled.size; ++row) {
+			if (board.at(row).size() != board.size()) {
+				throw std::invalid_argument("Row " + std::to_string(row + 1) + " of the board has " + std::to_string(board.at(row).size())
+					+ " columns instead of " + std::to_string(board.size()) + ". Rules cannot be used.");
+			}
+			for (int col = 0; col < compiled.size; ++col) {
+				std::string piece = board.at(row).at(col).get<std::string>();
+				compiled.board.push_back(piece.empty() ? EMPTY : piece[0]);
+			}
+		}
+		std::string royal = rules.at(RULES_ROYAL).get<std::string>();
+		if (royal.empty()) {
+			throw std::invalid_argument("Royal piece is missing. Rules cannot be used.");
+		}
+		compiled.royal[WHITE] = char(toupper(royal[0]));
+		compiled.royal[BLACK] = char(tolower(royal[0]));
+	} catch (const json::exception&) {	//missing key, row or column, or not a string
+		throw std::invalid_argument("Board or royal piece is missing. Rules cannot be used.");
 	}
-}
+	return compiled;
+}
\ No newline at end of file
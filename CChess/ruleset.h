@@ -2,53 +2,71 @@
 #define RULESET_H
 
 #include <iostream>		// std::cout
+#include <map>
+#include <vector>
 #include "constants.h"
 #include <nlohmann/json.hpp>
 // for convenience
 using json = nlohmann::json;
 
 
+/*
+	@brief		the selected rules object of the json, copied out when it is selected so queries don't touch the json
+*/
+struct CompiledRules {
+	int size;						//number of rows and columns of the board, see isBoardSize
+	std::vector<char> board;		//initial piece char of every square, row by row from the first row, EMPTY for none
+	char royal[2];					//royal piece char of each side, cased for the side
+};
+
+/*
+	@brief		every rules object of ruleset.json, compiled when loaded; immutable afterwards, so one Ruleset
+				can be shared by any number of boards (see RulesRegistry), each pointing at the rules it uses
+*/
 class Ruleset {
 public:
 	/*
-		@brief		loads json where pieces are stored
+		@brief		loads json where rules are stored and compiles every rules object
 	*/
-	Ruleset(const std::string& rules_name = DEFAULT_RULES);
+	Ruleset();
 
 	/*
 		@param		name		name of rules object in json
 
-		@throw		invalid_argument if name is not an object in the json
+		@return		compiled rules named name, valid as long as the Ruleset
+
+		@throw		invalid_argument if name is not an object in the json, or is missing its board or royal
 	*/
-	void setRules(const std::string& name);
+	const CompiledRules& getRules(const std::string& name) const;
 
-	/*
-		@param		row			row in board array
-		@param		col			column in board array
+	void printAll() const;
 
-		@return		char of a piece from board array
+	/*
+		@return		name of every rules object in json
 	*/
-	const char getInitialBoardAt(const int& row, const int& col) const;
+	std::vector<std::string> getNames() const;
 
+private:
 	/*
-		@param		side		for capitalization of royal
+		@param		rules		rules object from json
 
-		@return		char of royal for side
-	*/
-	const char getRoyal(const int& side) const;
+		@return		rules as a CompiledRules
 
-	void printAll() const;
+		@throw		invalid_argument if rules is missing its board or royal, or its board isn't square and of a supported size
+	*/
+	static CompiledRules compile(const json& rules);
 
-private:
+	// Member variables
+	// ----------------
 	/*
-		@brief		name of rules object in json
+		@brief		rules objects that compiled, by name
 	*/
-	std::string m_rules_name;
+	std::map<std::string, CompiledRules> m_compiled;
 
 	/*
-		@brief		all rules from json
+		@brief		why each rules object that didn't compile can't be used, by name; reported when it is selected
 	*/
-	json m_ruleset;
+	std::map<std::string, std::string> m_errors;
 };
 
 #endif RULESET_H
\ No newline at end of file
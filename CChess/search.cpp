@@ -0,0 +1,318 @@
+#include <iostream>		// std::cout
+#include <algorithm>	// std::stable_sort, std::min, std::swap
+#include <cstdlib>		// std::abs
+
+#include "search.h"
+
+
+const int Search::MATE;
+const int Search::INFINITE_SCORE;
+const int Search::MAX_PLY;
+const int Search::DEFAULT_MILLISECONDS;
+
+namespace {
+	const Move NO_MOVE = { NO_SQUARE, NO_SQUARE, MOVE_NORMAL };
+
+	//ordering priorities, highest first
+	const int PRIORITY_HASH = 1 << 30;
+	const int PRIORITY_CAPTURE = 1 << 20;	//plus most valuable victim, least valuable attacker
+	const int PRIORITY_KILLER = 1 << 19;	//quiet moves below this are ordered by history
+
+	//helper thread i searches a depth only if ((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) is even, cycling every 20 helpers
+	const int SKIP_CYCLE = 20;
+	const int SKIP_SIZE[SKIP_CYCLE] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+	const int SKIP_PHASE[SKIP_CYCLE] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+}
+
+
+// Public
+// ------
+Search::Search(Board& board, TranspositionTable& tt) : m_board(board), m_tt(tt), m_values(128 * SQUARES, 0), m_history(),
+	m_shared(nullptr), m_thread(0) {
+	//a piece is worth roughly how many squares it can reach on an empty board, on average and from where it stands
+	const PieceLibrary& plib = board.pieces();
+	const AttackTable& attacks = board.attacks();
+	for (int piece = 0; piece < plib.size(); ++piece) {
+		for (int side = WHITE; side <= BLACK; ++side) {
+			int reach[SQUARES], total = 0;
+			for (Square sq = 0; sq < SQUARES; ++sq) {
+				reach[sq] = popCount(attacks.attacks(OFFSET_MOVE, piece, side, sq, 0) | attacks.attacks(OFFSET_CAPTURE, piece, side, sq, 0));
+				total += reach[sq];
+			}
+			char c = (side == WHITE) ? plib.getPiece(piece) : char(tolower(plib.getPiece(piece)));
+			for (Square sq = 0; sq < SQUARES; ++sq) {
+				int value = 10 * total / SQUARES + 2 * (reach[sq] - total / SQUARES);
+				m_values[c * SQUARES + sq] = (side == WHITE) ? value : -value;
+			}
+		}
+	}
+}
+
+void Search::join(Shared* shared, const int& thread) {
+	m_shared = shared;
+	m_thread = thread;
+}
+
+SearchResult Search::think(const int& milliseconds, const int& maxDepth, const bool& verbose) {
+	auto start = std::chrono::steady_clock::now();
+	m_timed = (milliseconds > 0);
+	m_deadline = start + std::chrono::milliseconds(milliseconds);
+	m_stopped = false;
+	m_nodes = 0;
+	for (int ply = 0; ply < MAX_PLY; ++ply) {
+		m_killers[ply][0] = m_killers[ply][1] = NO_MOVE;
+	}
+	for (Square from = 0; from < SQUARES; ++from) {	//keep some of what earlier searches learned
+		for (Square to = 0; to < SQUARES; ++to) {
+			m_history[from][to] /= 2;
+		}
+	}
+	if (!m_shared) {	//a parallel search ages the table once for all its threads
+		m_tt.newSearch();
+	}
+
+	SearchResult result = { NO_MOVE, -MATE, 0, 0, 0 };
+	std::vector<Move> legal = m_board.generateLegalMoves(m_board.turn());
+	if (!legal.empty()) {
+		result.best = m_rootBest = legal[0];	//something to play even if the first iteration can't finish
+		for (int depth = 1; depth <= std::min(maxDepth, MAX_PLY - 1); ++depth) {
+			if (skipDepth(depth)) {
+				continue;
+			}
+			m_rootCompleted = 0;
+			int score = negamax(depth, 0, -INFINITE_SCORE, INFINITE_SCORE);
+			//the previous best move is searched first, so a root move that finished before time ran out is at least as good
+			if (m_rootCompleted > 0) {
+				result.best = m_rootBest;
+				result.score = m_stopped ? m_rootScore : score;
+			}
+			if (m_stopped) {
+				break;
+			}
+			result.depth = depth;
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			if (verbose) {
+				std::cout << "depth " << depth << "\tscore " << score << "\tnodes " << m_nodes << "\ttime " << int(seconds * 1000)
+					<< " ms\tbest " << toAlgebraic(result.best.current) << '-' << toAlgebraic(result.best.future) << std::endl;
+			}
+			if (std::abs(score) >= MATE - MAX_PLY) {	//forced mate found, deeper won't change the move
+				break;
+			}
+			if (m_timed && seconds * 1000 * 2 > milliseconds) {	//next iteration would most likely not finish
+				break;
+			}
+		}
+	}
+	result.nodes = m_nodes;
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+int Search::evaluate(const int& side) const {
+	int score = 0;
+	for (Bitboard pieces = m_board.piecesOf(WHITE) | m_board.piecesOf(BLACK); pieces;) {
+		Square sq = popLsb(pieces);
+		score += m_values[m_board.pieceAt(sq) * SQUARES + sq];
+	}
+	return (side == WHITE) ? score : -score;
+}
+
+// Private
+// -------
+int Search::negamax(const int& depth, const int& ply, int alpha, const int& beta) {
+	if (depth <= 0) {
+		return quiescence(ply, alpha, beta);
+	}
+	if (checkTime()) {
+		return 0;
+	}
+	int side = m_board.turn();
+	if (ply >= MAX_PLY - 1) {
+		return evaluate(side);
+	}
+	uint64_t key = m_board.hash();
+	TTEntry entry;
+	Move hashMove = NO_MOVE;
+	if (m_tt.probe(key, entry)) {
+		hashMove = entry.best;
+		if (ply > 0 && entry.depth >= depth) {	//the root always searches, so it has a move to return
+			int score = fromTT(entry.score, ply);
+			if (entry.bound == BOUND_EXACT || (entry.bound == BOUND_LOWER && score >= beta) || (entry.bound == BOUND_UPPER && score <= alpha)) {
+				return score;
+			}
+		}
+	}
+	if (ply == 0) {	//the table entry may have been replaced, but the last iteration's best move must come first
+		hashMove = m_rootBest;
+	}
+	std::vector<Move> moves = m_board.generateLegalMoves(side);
+	if (moves.empty()) {	//no legal move loses, whether in check or not
+		return -MATE + ply;
+	}
+
+	int alphaOriginal = alpha;
+	int best = -INFINITE_SCORE;
+	Move bestMove = moves[0];
+	std::vector<ScoredMove> ordered = order(moves, hashMove, ply);
+	for (size_t i = 0; i < ordered.size(); ++i) {
+		if (ply == 0 && m_shared && i > 0) {	//every thread starts with its own best move, then takes whatever is left
+			claimRootMove(moves, ordered, i, depth);
+		}
+		const Move& m = ordered[i].move;
+		Board::Undo undo = m_board.makeMove(m.current, m.future);
+		int score = -negamax(depth - 1, ply + 1, -beta, -alpha);
+		m_board.unmakeMove(undo);
+		if (m_stopped) {
+			return 0;
+		}
+		if (ply == 0) {
+			++m_rootCompleted;
+		}
+		if (score > best) {
+			best = score;
+			bestMove = m;
+			if (ply == 0) {
+				m_rootBest = m;
+				m_rootScore = score;
+			}
+		}
+		if (score > alpha) {
+			alpha = score;
+		}
+		if (alpha >= beta) {
+			if (m.type != MOVE_CAPTURE) {	//remember quiet moves that refute the opponent's move
+				if (!same(m, m_killers[ply][0])) {
+					m_killers[ply][1] = m_killers[ply][0];
+					m_killers[ply][0] = m;
+				}
+				m_history[m.current][m.future] += depth * depth;
+			}
+			break;
+		}
+	}
+
+	entry.depth = depth;
+	entry.bound = (best >= beta) ? BOUND_LOWER : ((best <= alphaOriginal) ? BOUND_UPPER : BOUND_EXACT);
+	entry.score = toTT(best, ply);
+	entry.best = bestMove;
+	m_tt.store(key, entry);
+	return best;
+}
+
+int Search::quiescence(const int& ply, int alpha, const int& beta) {
+	if (checkTime()) {
+		return 0;
+	}
+	int side = m_board.turn();
+	std::vector<Move> moves = m_board.generateLegalMoves(side);
+	if (moves.empty()) {
+		return -MATE + ply;
+	}
+	int best = evaluate(side);	//standing pat: the side to move need not capture
+	if (best >= beta || ply >= MAX_PLY - 1) {
+		return best;
+	}
+	if (best > alpha) {
+		alpha = best;
+	}
+	std::vector<Move> captures;
+	for (const Move& m : moves) {
+		if (m.type == MOVE_CAPTURE) {
+			captures.push_back(m);
+		}
+	}
+	for (const ScoredMove& sm : order(captures, NO_MOVE, ply)) {
+		Board::Undo undo = m_board.makeMove(sm.move.current, sm.move.future);
+		int score = -quiescence(ply + 1, -beta, -alpha);
+		m_board.unmakeMove(undo);
+		if (m_stopped) {
+			return 0;
+		}
+		if (score > best) {
+			best = score;
+		}
+		if (score > alpha) {
+			alpha = score;
+		}
+		if (alpha >= beta) {
+			break;
+		}
+	}
+	return best;
+}
+
+std::vector<Search::ScoredMove> Search::order(const std::vector<Move>& moves, const Move& hashMove, const int& ply) const {
+	std::vector<ScoredMove> scored;
+	scored.reserve(moves.size());
+	for (const Move& m : moves) {
+		int priority;
+		if (same(m, hashMove)) {
+			priority = PRIORITY_HASH;
+		} else if (m.type == MOVE_CAPTURE) {
+			int victim = std::abs(m_values[m_board.pieceAt(m.future) * SQUARES + m.future]);
+			int attacker = std::abs(m_values[m_board.pieceAt(m.current) * SQUARES + m.current]);
+			priority = PRIORITY_CAPTURE + victim * 64 - attacker;
+		} else if (same(m, m_killers[ply][0])) {
+			priority = PRIORITY_KILLER;
+		} else if (same(m, m_killers[ply][1])) {
+			priority = PRIORITY_KILLER - 1;
+		} else {
+			priority = std::min(m_history[m.current][m.future], PRIORITY_KILLER - 2);
+		}
+		scored.push_back({ m, priority });
+	}
+	std::stable_sort(scored.begin(), scored.end(), [](const ScoredMove& a, const ScoredMove& b) { return a.priority > b.priority; });
+	return scored;
+}
+
+void Search::claimRootMove(const std::vector<Move>& moves, std::vector<ScoredMove>& ordered, const size_t& i, const int& depth) {
+	for (int next = m_shared->nextRootMove[depth]++; next < int(moves.size()); next = m_shared->nextRootMove[depth]++) {
+		for (size_t j = i; j < ordered.size(); ++j) {
+			if (same(ordered[j].move, moves[next])) {
+				std::swap(ordered[i], ordered[j]);
+				return;
+			}
+		}
+		//already searched by this thread (its first move), so claim another
+	}
+}
+
+bool Search::skipDepth(const int& depth) const {
+	if (m_thread == 0) {
+		return false;
+	}
+	int i = (m_thread - 1) % SKIP_CYCLE;
+	return ((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2 != 0;
+}
+
+bool Search::checkTime() {
+	if ((++m_nodes & 1023) == 0 && m_timed && std::chrono::steady_clock::now() >= m_deadline) {
+		m_stopped = true;
+	}
+	if (m_shared && m_shared->stop.load(std::memory_order_relaxed)) {
+		m_stopped = true;
+	}
+	return m_stopped;
+}
+
+int Search::toTT(const int& score, const int& ply) {
+	if (score >= MATE - MAX_PLY) {
+		return score + ply;
+	} else if (score <= -MATE + MAX_PLY) {
+		return score - ply;
+	}
+	return score;
+}
+
+int Search::fromTT(const int& score, const int& ply) {
+	if (score >= MATE - MAX_PLY) {
+		return score - ply;
+	} else if (score <= -MATE + MAX_PLY) {
+		return score + ply;
+	}
+	return score;
+}
+
+bool Search::same(const Move& a, const Move& b) {
+	return a.current == b.current && a.future == b.future;
+}
@@ -0,0 +1,228 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "board.h"
+#include "transposition_table.h"
+
+
+/*
+	@brief		outcome of Search::think
+*/
+struct SearchResult {
+	Move best;				//current is NO_SQUARE if the side to move has no legal move
+	int score;				//centipawn-like score for the side to move; mates are within MAX_PLY of +/-MATE
+	int depth;				//deepest iteration completed
+	long long nodes;
+	double seconds;
+};
+
+/*
+	@brief		chooses a move for the side to move on a Board: negamax alpha-beta with iterative deepening,
+				a quiescence search over captures, and a hard deadline
+				works for any piece set, since piece values are worked out from the piece library
+*/
+class Search {
+public:
+	/*
+		@param		board		position to search; moves are made and unmade on it, so it is unchanged afterwards
+		@param		tt			transposition table, possibly shared with other searches
+	*/
+	Search(Board& board, TranspositionTable& tt);
+
+	static const int MAX_PLY = 64;
+
+	/*
+		@brief		state shared by searches of the same root running in parallel (see ParallelSearch)
+	*/
+	struct Shared {
+		std::atomic<bool> stop;					//set once the main search is done; helpers stop as soon as they see it
+		std::atomic<int> nextRootMove[MAX_PLY];	//per depth, index of the next root move (in generation order) no thread has claimed
+	};
+
+	/*
+		@brief		makes this search one of several running in parallel: helpers (thread > 0) skip some depths so
+					threads spread over different iterations, and every thread claims root moves from shared counters
+					so each starts on different moves; all of them share the transposition table
+
+		@param		shared		state shared between the threads, outliving the search
+		@param		thread		index of this thread, 0 for the main search
+	*/
+	void join(Shared* shared, const int& thread);
+
+	/*
+		@param		milliseconds	time budget; the best move found so far is returned once it runs out (0 for no limit)
+		@param		maxDepth		deepest iteration to start, at most MAX_PLY
+		@param		verbose			if true, prints a line to standard output after every completed iteration
+
+		@return		best move found and statistics of the search
+	*/
+	SearchResult think(const int& milliseconds, const int& maxDepth = MAX_PLY, const bool& verbose = false);
+
+	/*
+		@param		side		enum of White or Black
+
+		@return		static evaluation of the board for side
+	*/
+	int evaluate(const int& side) const;
+
+	static const int MATE = 30000;		//score of giving mate now; fits the 16 bits of a TTEntry score
+	static const int INFINITE_SCORE = 32000;
+	static const int DEFAULT_MILLISECONDS = 1000;
+
+private:
+	/*
+		@brief		move paired with its ordering priority
+	*/
+	struct ScoredMove {
+		Move move;
+		int priority;
+	};
+
+	/*
+		@param		depth		remaining depth in plies
+		@param		ply			distance from the root
+		@param		alpha		lower bound of the window
+		@param		beta		upper bound of the window
+
+		@return		score of the board for the side to move, from within [alpha, beta] if the true score is
+	*/
+	int negamax(const int& depth, const int& ply, int alpha, const int& beta);
+
+	/*
+		@brief		searches captures only until the position is quiet, so the evaluation isn't taken mid-exchange
+
+		@param		ply			distance from the root
+		@param		alpha		lower bound of the window
+		@param		beta		upper bound of the window
+
+		@return		score of the board for the side to move
+	*/
+	int quiescence(const int& ply, int alpha, const int& beta);
+
+	/*
+		@brief		orders moves: move from the transposition table, captures of valuable pieces by cheap ones,
+					killer moves, then quiet moves by history
+
+		@param		moves		legal moves to order
+		@param		hashMove	best move stored in the transposition table (current is NO_SQUARE if none)
+		@param		ply			distance from the root, for killer moves
+
+		@return		moves sorted best first
+	*/
+	std::vector<ScoredMove> order(const std::vector<Move>& moves, const Move& hashMove, const int& ply) const;
+
+	/*
+		@brief		at the root of a parallel search, moves the next root move no thread has claimed yet to position i
+					(left as is once every root move has been claimed, so each thread still searches every move)
+
+		@param		moves		root moves in generation order, the same in every thread
+		@param		ordered		root moves in this thread's order, already searched before i
+		@param		i			position of the move about to be searched
+		@param		depth		depth of the iteration in progress
+	*/
+	void claimRootMove(const std::vector<Move>& moves, std::vector<ScoredMove>& ordered, const size_t& i, const int& depth);
+
+	/*
+		@param		depth		depth of a possible iteration
+
+		@return		true if this helper thread skips the iteration
+	*/
+	bool skipDepth(const int& depth) const;
+
+	/*
+		@brief		counts a node and sets m_stopped once the deadline has passed (the clock is only read every 1024 nodes)
+					or the shared stop flag is set
+
+		@return		true if the search must stop
+	*/
+	bool checkTime();
+
+	/*
+		@param		score		score relative to the current ply
+
+		@return		score relative to this position, for storing mate scores in the transposition table
+	*/
+	static int toTT(const int& score, const int& ply);
+
+	/*
+		@param		score		score relative to the stored position
+
+		@return		score relative to the current ply
+	*/
+	static int fromTT(const int& score, const int& ply);
+
+	/*
+		@param		a			a move
+		@param		b			another move
+
+		@return		true if a and b are the same move
+	*/
+	static bool same(const Move& a, const Move& b);
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		board being searched
+	*/
+	Board& m_board;
+
+	/*
+		@brief		table of results from this and other searches
+	*/
+	TranspositionTable& m_tt;
+
+	/*
+		@brief		value of every piece char (both cases) on every square, positive for White;
+					material from how many squares the piece reaches on an empty board, plus a bonus where it reaches more
+	*/
+	std::vector<int> m_values;
+
+	/*
+		@brief		two quiet moves per ply that recently caused a beta cutoff
+	*/
+	Move m_killers[MAX_PLY][2];
+
+	/*
+		@brief		how often each quiet move (by from and to square) caused a beta cutoff, weighted by depth
+	*/
+	int m_history[SQUARES][SQUARES];
+
+	/*
+		@brief		best root move so far: from the last iteration, until a root move of this one beats it
+	*/
+	Move m_rootBest;
+
+	int m_rootScore;
+
+	/*
+		@brief		number of root moves fully searched in the iteration in progress
+	*/
+	int m_rootCompleted;
+
+	long long m_nodes;
+
+	/*
+		@brief		search must stop by this time, if m_timed
+	*/
+	std::chrono::steady_clock::time_point m_deadline;
+
+	bool m_timed;
+
+	/*
+		@brief		true once the deadline has passed; every score computed afterwards is meaningless
+	*/
+	bool m_stopped;
+
+	/*
+		@brief		state shared with parallel searches (nullptr if searching alone), and index of this thread
+	*/
+	Shared* m_shared;
+
+	int m_thread;
+};
+
+#endif SEARCH_H
@@ -0,0 +1,481 @@
+#include <iostream>		// std::cout
+#include <sstream>		// std::istringstream
+#include <thread>		// std::thread
+#include <chrono>		// std::chrono::steady_clock
+#include <algorithm>	// std::max, std::sort, std::remove
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>	// socket, WSAPoll
+#include <ws2tcpip.h>	// socklen_t
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>	// socket, recv, send
+#include <netinet/in.h>	// sockaddr_in
+#include <netinet/tcp.h>	// TCP_NODELAY
+#include <arpa/inet.h>	// htonl, htons
+#include <poll.h>		// poll
+#include <fcntl.h>		// fcntl
+#include <unistd.h>		// close
+#include <cerrno>		// errno
+#endif
+
+#include "constants.h"
+#include "server.h"
+#include "protocol.h"
+
+
+namespace {
+#ifdef _WIN32
+	typedef SOCKET NativeSocket;
+	typedef WSAPOLLFD PollFd;
+	const NativeSocket BAD_SOCKET = INVALID_SOCKET;
+	const int SEND_FLAGS = 0;
+
+	int pollSockets(PollFd* fds, const size_t& count, const int& milliseconds) {
+		return WSAPoll(fds, ULONG(count), milliseconds);
+	}
+
+	void closeSocket(const NativeSocket& s) {
+		closesocket(s);
+	}
+
+	bool wouldBlock() {
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	void setNonBlocking(const NativeSocket& s) {
+		u_long on = 1;
+		ioctlsocket(s, FIONBIO, &on);
+	}
+#else
+	typedef int NativeSocket;
+	typedef pollfd PollFd;
+	const NativeSocket BAD_SOCKET = -1;
+#ifdef MSG_NOSIGNAL
+	const int SEND_FLAGS = MSG_NOSIGNAL;	//a client that went away is an error, not a SIGPIPE
+#else
+	const int SEND_FLAGS = 0;
+#endif
+
+	int pollSockets(PollFd* fds, const size_t& count, const int& milliseconds) {
+		return poll(fds, nfds_t(count), milliseconds);
+	}
+
+	void closeSocket(const NativeSocket& s) {
+		close(s);
+	}
+
+	bool wouldBlock() {
+		return errno == EAGAIN || errno == EWOULDBLOCK;
+	}
+
+	void setNonBlocking(const NativeSocket& s) {
+		fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+	}
+#endif
+
+	/*
+		@brief		sends small replies at once instead of waiting to fill a packet
+	*/
+	void setNoDelay(const NativeSocket& s) {
+		int on = 1;
+		setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+	}
+
+	/*
+		@return		little-endian length at the start of bytes, which holds at least 4
+	*/
+	uint32_t frameLength(const char* bytes) {
+		const unsigned char* b = reinterpret_cast<const unsigned char*>(bytes);
+		return uint32_t(b[0]) | (uint32_t(b[1]) << 8) | (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+	}
+
+	/*
+		@brief		blocking client side of a frame exchange, for bench
+
+		@return		reply to request
+
+		@throw		std::invalid_argument if the connection breaks
+	*/
+	std::string request(const NativeSocket& s, const std::string& framed) {
+		for (size_t sent = 0; sent < framed.size();) {
+			int n = send(s, framed.data() + sent, int(framed.size() - sent), SEND_FLAGS);
+			if (n <= 0) {
+				throw std::invalid_argument("Connection to server lost.");
+			}
+			sent += size_t(n);
+		}
+		std::string reply;
+		char buffer[4096];
+		while (reply.size() < 4 || reply.size() < 4 + frameLength(reply.data())) {
+			int n = recv(s, buffer, int(sizeof(buffer)), 0);
+			if (n <= 0) {
+				throw std::invalid_argument("Connection to server lost.");
+			}
+			reply.append(buffer, size_t(n));
+		}
+		return reply.substr(4);
+	}
+}
+
+
+// Public
+// ------
+Server::Server(const int& port, const int& threads) : m_listener(Socket(BAD_SOCKET)), m_port(port), m_threads(std::max(threads, 1)), m_stopped(false) {
+#ifdef _WIN32
+	WSADATA data;
+	WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+	NativeSocket listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);	//local clients only
+	address.sin_port = htons(uint16_t(port));
+	int on = 1;
+	socklen_t length = sizeof(address);
+	if (listener == BAD_SOCKET
+		|| setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on)) != 0
+		|| bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+		|| listen(listener, SOMAXCONN) != 0
+		|| getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+		if (listener != BAD_SOCKET) {
+			closeSocket(listener);
+		}
+#ifdef _WIN32
+		WSACleanup();
+#endif
+		throw std::invalid_argument("Cannot listen on port " + std::to_string(port));
+	}
+	setNonBlocking(listener);
+	m_listener = Socket(listener);
+	m_port = ntohs(address.sin_port);
+}
+
+Server::~Server() {
+	closeSocket(NativeSocket(m_listener));
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+void Server::serve() {
+	m_stopped = false;
+	std::vector<std::thread> workers;
+	for (int t = 1; t < m_threads; ++t) {
+		workers.emplace_back(&Server::work, this);
+	}
+	work();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+void Server::stop() {
+	m_stopped = true;
+}
+
+int Server::port() const {
+	return m_port;
+}
+
+int Server::run(const std::vector<std::string>& args) {
+	try {
+		int threads = int(std::thread::hardware_concurrency());
+		if (!args.empty() && args[0] == SERVER_BENCH && args.size() <= 4) {
+			int sessions = (args.size() > 1) ? std::stoi(args[1]) : 10000;
+			int moves = (args.size() > 2) ? std::stoi(args[2]) : 10;
+			threads = (args.size() > 3) ? std::stoi(args[3]) : threads;
+			Server server(0, threads);
+			std::thread serving(&Server::serve, &server);
+			try {
+				bench(server.port(), sessions, moves, server.m_threads);
+			} catch (const std::invalid_argument&) {
+				server.stop();
+				serving.join();
+				throw;
+			}
+			server.stop();
+			serving.join();
+			return 0;
+		} else if (args.size() <= 2 && (args.empty() || args[0] != SERVER_BENCH)) {
+			int port = (args.size() > 0) ? std::stoi(args[0]) : SERVER_PORT;
+			threads = (args.size() > 1) ? std::stoi(args[1]) : threads;
+			Server server(port, threads);
+			std::cout << "Serving on 127.0.0.1:" << server.port() << " with " << server.m_threads << " workers" << std::endl;
+			server.serve();
+			return 0;
+		}
+		std::cout << "Usage: " << SERVER << " [<port> [<threads>]]\t|\t" << SERVER << ' ' << SERVER_BENCH << " [<sessions> [<moves> [<threads>]]]" << std::endl;
+		return 1;
+	} catch (const std::exception& e) {	//port in use, or an argument isn't a number
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
+
+// Private
+// -------
+void Server::work() {
+	std::vector<std::unique_ptr<Connection>> connections;
+	std::vector<PollFd> fds;
+	while (!m_stopped.load(std::memory_order_relaxed)) {
+		fds.assign(1, PollFd());
+		fds[0].fd = NativeSocket(m_listener);
+		fds[0].events = POLLIN;
+		for (const std::unique_ptr<Connection>& c : connections) {
+			PollFd fd = PollFd();
+			fd.fd = NativeSocket(c->socket);
+			//only wait to write if the socket was full, and stop reading from a client that doesn't read its replies
+			fd.events = short((c->out.size() < SERVER_MAX_FRAME ? POLLIN : 0) | (c->out.empty() ? 0 : POLLOUT));
+			fds.push_back(fd);
+		}
+		if (pollSockets(fds.data(), fds.size(), SERVER_POLL_MILLISECONDS) <= 0) {
+			continue;
+		}
+		for (size_t i = 0; i < connections.size(); ++i) {
+			short events = fds[i + 1].revents;
+			if (!events) {
+				continue;
+			}
+			Connection& c = *connections[i];
+			bool open = !(events & (POLLERR | POLLNVAL));
+			if (open && (events & (POLLIN | POLLHUP))) {
+				open = receive(c);
+			}
+			if (open && !c.out.empty()) {	//replies go out in the same pass as the requests that caused them
+				open = transmit(c) && respond(c);	//requests held back while out was full
+			}
+			if (!open) {	//its sessions end with it
+				closeSocket(NativeSocket(c.socket));
+				connections[i].reset();
+			}
+		}
+		connections.erase(std::remove(connections.begin(), connections.end(), nullptr), connections.end());
+		if (fds[0].revents & POLLIN) {	//every worker polls the listener; whichever accepts first owns the connection
+			NativeSocket s = accept(NativeSocket(m_listener), nullptr, nullptr);
+			if (s != BAD_SOCKET) {	//one at a time, so a burst of connections is spread over the workers
+				setNonBlocking(s);
+				setNoDelay(s);
+				connections.emplace_back(new Connection{ Socket(s), "", "", {}, 0 });
+			}
+		}
+	}
+	for (const std::unique_ptr<Connection>& c : connections) {
+		closeSocket(NativeSocket(c->socket));
+	}
+}
+
+bool Server::receive(Connection& connection) {
+	char buffer[4096];
+	for (;;) {
+		int n = recv(NativeSocket(connection.socket), buffer, int(sizeof(buffer)), 0);
+		if (n > 0) {
+			connection.in.append(buffer, size_t(n));
+			if (n < int(sizeof(buffer)) || connection.in.size() > 4 + SERVER_MAX_FRAME) {	//drained, or a whole frame is in
+				break;
+			}
+		} else if (n < 0 && wouldBlock()) {
+			break;
+		} else {	//closed by the client, or failed
+			return false;
+		}
+	}
+	return respond(connection);
+}
+
+bool Server::respond(Connection& connection) {
+	size_t pos = 0;
+	while (connection.in.size() - pos >= 4 && connection.out.size() < SERVER_MAX_FRAME) {	//the rest waits for out to drain
+		uint32_t length = frameLength(connection.in.data() + pos);
+		if (length > SERVER_MAX_FRAME) {
+			return false;
+		}
+		if (connection.in.size() - pos - 4 < length) {	//rest of the frame hasn't arrived
+			break;
+		}
+		std::string reply = handle(connection, connection.in.substr(pos + 4, length));
+		if (reply.size() > SERVER_MAX_FRAME) {
+			reply = "error Reply is longer than " + std::to_string(SERVER_MAX_FRAME) + " bytes";
+		}
+		connection.out += frame(reply);
+		pos += 4 + length;
+	}
+	connection.in.erase(0, pos);
+	return true;
+}
+
+bool Server::transmit(Connection& connection) {
+	size_t sent = 0;
+	while (sent < connection.out.size()) {
+		int n = send(NativeSocket(connection.socket), connection.out.data() + sent, int(connection.out.size() - sent), SEND_FLAGS);
+		if (n > 0) {
+			sent += size_t(n);
+		} else if (n < 0 && wouldBlock()) {	//the rest goes once poll says the socket has room
+			break;
+		} else {
+			return false;
+		}
+	}
+	connection.out.erase(0, sent);
+	return true;
+}
+
+std::string Server::handle(Connection& connection, const std::string& request) {
+	std::istringstream in(request);
+	std::string command;
+	in >> command;
+	try {
+		if (command == SERVER_NEW) {
+			if (connection.sessions.size() >= SERVER_MAX_SESSIONS) {
+				throw std::invalid_argument("No more than " + std::to_string(SERVER_MAX_SESSIONS) + " sessions per connection");
+			}
+			std::string rules = DEFAULT_RULES;
+			in >> rules;
+			Session session;
+			session.board.reset(rules);
+			uint32_t id = connection.nextSession++;
+			connection.sessions.emplace(id, std::move(session));
+			return "ok " + std::to_string(id);
+		} else if (command == SERVER_STATS) {
+			return "ok " + std::to_string(connection.sessions.size());
+		} else if (command != SERVER_MOVE && command != SERVER_LEGAL && command != SERVER_UNDO && command != SERVER_HISTORY && command != SERVER_CLOSE) {
+			throw std::invalid_argument("Unknown request " + command);
+		}
+		uint32_t id;
+		if (!(in >> id)) {
+			throw std::invalid_argument("Expected a session after " + command);
+		}
+		auto found = connection.sessions.find(id);
+		if (found == connection.sessions.end()) {
+			throw std::invalid_argument("No session " + std::to_string(id));
+		}
+		Session& session = found->second;
+		Board& board = session.board;
+		std::string reply = "ok";
+		if (command == SERVER_MOVE) {
+			std::string text;
+			in >> text;
+			Move m = Protocol::parseMove(text);
+			Board::Undo undo;
+			MoveStatus status = board.tryMove(m.current, m.future, board.turn(), &undo);
+			if (status != MOVE_OK) {	//rejected moves are common here, so they don't unwind
+				return "error " + board.describe(status, m.current);
+			}
+			session.history.push_back(undo);
+			if (board.generateLegalMoves(board.turn()).empty()) {	//no legal move loses, whether in check or not
+				reply += " mate";
+			} else if (board.inCheck(board.turn())) {
+				reply += " check";
+			}
+		} else if (command == SERVER_LEGAL) {
+			for (const Move& m : board.generateLegalMoves(board.turn())) {
+				reply += ' ' + toAlgebraic(m.current) + toAlgebraic(m.future);
+			}
+		} else if (command == SERVER_UNDO) {
+			if (session.history.empty()) {
+				throw std::invalid_argument("No moves to undo!");
+			}
+			board.unmakeMove(session.history.back());
+			session.history.pop_back();
+		} else if (command == SERVER_HISTORY) {
+			for (const Board::Undo& undo : session.history) {
+				reply += ' ' + toAlgebraic(undo.current) + toAlgebraic(undo.future);
+			}
+		} else {	//close
+			connection.sessions.erase(found);
+		}
+		return reply;
+	} catch (const std::exception& e) {	//illegal move, unknown rules or session, malformed request, or out of memory
+		return std::string("error ") + e.what();
+	}
+}
+
+void Server::bench(const int& port, const int& sessions, const int& moves, const int& connections) {
+	//at least one connection per worker, and few enough sessions on each to stay under SERVER_MAX_SESSIONS
+	size_t count = std::max(size_t(std::max(connections, 1)), (size_t(std::max(sessions, 0)) + SERVER_MAX_SESSIONS - 1) / SERVER_MAX_SESSIONS);
+	std::vector<NativeSocket> sockets;
+	auto closeAll = [&sockets]() {
+		for (const NativeSocket& s : sockets) {
+			closeSocket(s);
+		}
+	};
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port = htons(uint16_t(port));
+	while (sockets.size() < count) {
+		NativeSocket s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (s == BAD_SOCKET || connect(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+			if (s != BAD_SOCKET) {
+				closeSocket(s);
+			}
+			closeAll();
+			throw std::invalid_argument("Cannot connect to port " + std::to_string(port));
+		}
+		setNoDelay(s);
+		sockets.push_back(s);
+	}
+	try {
+		//session i lives on connection i % count
+		std::vector<std::string> ids;
+		for (int i = 0; i < sessions; ++i) {
+			std::string reply = request(sockets[i % count], frame(SERVER_NEW));
+			if (reply.compare(0, 3, "ok ") != 0) {
+				throw std::invalid_argument("Server refused a session: " + reply);
+			}
+			ids.push_back(reply.substr(3));	//"ok <session>"
+		}
+		//every round, each live session plays one of its legal moves; only the move requests are timed
+		std::vector<bool> over(sessions, false);
+		std::vector<double> latencies;
+		latencies.reserve(size_t(sessions) * moves);
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < moves; ++round) {
+			for (int i = 0; i < sessions; ++i) {
+				if (over[i]) {
+					continue;
+				}
+				NativeSocket s = sockets[i % count];
+				std::istringstream legal(request(s, frame(SERVER_LEGAL + ' ' + ids[i])));
+				std::vector<std::string> choices;
+				std::string word;
+				legal >> word;	//"ok"
+				while (legal >> word) {
+					choices.push_back(word);
+				}
+				if (choices.empty()) {
+					over[i] = true;
+					continue;
+				}
+				std::string move = frame(SERVER_MOVE + ' ' + ids[i] + ' ' + choices[(round * 31 + i * 17) % choices.size()]);
+				auto sent = std::chrono::steady_clock::now();
+				std::string reply = request(s, move);
+				latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - sent).count());
+				if (reply.compare(0, 2, "ok") != 0) {
+					throw std::invalid_argument("Server rejected a legal move: " + reply);
+				}
+			}
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		closeAll();
+		std::sort(latencies.begin(), latencies.end());
+		auto percentile = [&latencies](const double& p) { return latencies.empty() ? 0 : latencies[size_t(p * (latencies.size() - 1))]; };
+		std::cout << sessions << " sessions over " << count << " connections, " << latencies.size() << " moves in " << seconds << " s (" << 2 * latencies.size() / (seconds > 0 ? seconds : 1e-9)
+			<< " requests/s)" << std::endl
+			<< "move latency:\tp50 " << percentile(0.5) << " us\tp99 " << percentile(0.99) << " us\tmax " << percentile(1) << " us" << std::endl;
+	} catch (const std::invalid_argument&) {
+		closeAll();
+		throw;
+	}
+}
+
+std::string Server::frame(const std::string& text) {
+	uint32_t length = uint32_t(text.size());
+	std::string framed;
+	framed.reserve(4 + text.size());
+	for (int i = 0; i < 4; ++i) {
+		framed += char((length >> (8 * i)) & 0xFF);
+	}
+	return framed + text;
+}
@@ -0,0 +1,171 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "board.h"
+
+
+/*
+	@brief		hosts many independent games in one process, over localhost TCP
+				a fixed pool of worker threads each runs its own event loop over non-blocking sockets: every worker
+				accepts connections from the shared listening socket and alone owns the connections it accepted and
+				their sessions, so handling a request never takes a lock or waits on I/O
+
+				requests and replies are frames: a 4 byte little-endian length followed by that many bytes of text
+				new [<rules>]			starts a session (DEFAULT_RULES if none); replies "ok <session>"
+				move <session> <m>		plays a move such as e2e4 if legal; replies "ok", "ok check" or "ok mate"
+				legal <session>			replies "ok" followed by every legal move of the side to move
+				undo <session>			takes back the last move
+				history <session>		replies "ok" followed by every move played
+				close <session>			ends a session
+				stats					replies "ok <sessions>" with the number of sessions of the connection
+				any request that fails replies "error <reason>"; sessions belong to the connection that started them
+				and end with it, and a connection holds at most SERVER_MAX_SESSIONS of them
+				a connection is not read from while SERVER_MAX_FRAME bytes of its replies are waiting to be sent
+*/
+class Server {
+public:
+	/*
+		@brief		listens on 127.0.0.1:port
+
+		@param		port		TCP port, 0 for any free one
+		@param		threads		number of worker threads, at least 1
+
+		@throw		std::invalid_argument if the port cannot be listened on
+	*/
+	Server(const int& port, const int& threads);
+
+	~Server();
+
+	Server(const Server&) = delete;
+	Server& operator=(const Server&) = delete;
+
+	/*
+		@brief		runs the workers until stop() is called
+	*/
+	void serve();
+
+	/*
+		@brief		makes serve() return within SERVER_POLL_MILLISECONDS (thread safe)
+	*/
+	void stop();
+
+	/*
+		@return		port the server listens on
+	*/
+	int port() const;
+
+	/*
+		@brief		entry point of the headless server mode, see main.cpp
+					server [<port> [<threads>]]							serves until the process is killed
+					server bench [<sessions> [<moves> [<threads>]]]		serves on a free port and plays moves in many sessions
+																		over one connection per worker (or more, to respect
+																		SERVER_MAX_SESSIONS), then prints latency percentiles
+
+		@param		args		command line arguments following "server"
+
+		@return		process exit code
+	*/
+	static int run(const std::vector<std::string>& args);
+
+private:
+#ifdef _WIN32
+	typedef uintptr_t Socket;	//SOCKET
+#else
+	typedef int Socket;
+#endif
+
+	/*
+		@brief		one game: its board and every move played, so it can be taken back
+	*/
+	struct Session {
+		Board board;
+		std::vector<Board::Undo> history;
+	};
+
+	/*
+		@brief		one client and its buffered, not yet complete requests and not yet sent replies
+	*/
+	struct Connection {
+		Socket socket;
+		std::string in;
+		std::string out;
+		std::unordered_map<uint32_t, Session> sessions;
+		uint32_t nextSession;
+	};
+
+	/*
+		@brief		event loop of one worker: accepts, reads, handles and writes until stopped
+	*/
+	void work();
+
+	/*
+		@brief		reads everything available (up to one whole frame) and calls respond()
+
+		@return		false if the connection was closed or sent a frame longer than SERVER_MAX_FRAME
+	*/
+	bool receive(Connection& connection);
+
+	/*
+		@brief		handles complete requests in connection.in until none is left or SERVER_MAX_FRAME bytes of replies
+					are waiting in connection.out (replies longer than SERVER_MAX_FRAME are replaced by an error)
+
+		@return		false if the connection sent a frame longer than SERVER_MAX_FRAME
+	*/
+	bool respond(Connection& connection);
+
+	/*
+		@brief		writes as many pending replies as the socket takes without blocking
+
+		@return		false if the connection was closed
+	*/
+	bool transmit(Connection& connection);
+
+	/*
+		@param		connection	connection the request came from
+		@param		request		text of one frame
+
+		@return		text of the reply
+	*/
+	std::string handle(Connection& connection, const std::string& request);
+
+	/*
+		@brief		plays sessions moves rounds of legal moves on a server, one request at a time, and prints latencies
+
+		@param		port		port of the server
+		@param		sessions	number of sessions to play at once, spread round-robin over the connections
+		@param		moves		number of moves to play in every session
+		@param		connections	least number of connections to open, e.g. one per worker of the server
+
+		@throw		std::invalid_argument if the server can't be reached or refuses a session or legal move
+	*/
+	static void bench(const int& port, const int& sessions, const int& moves, const int& connections);
+
+	/*
+		@param		text		text to frame
+
+		@return		text preceded by its length
+	*/
+	static std::string frame(const std::string& text);
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		non-blocking socket every worker accepts connections from
+	*/
+	Socket m_listener;
+
+	int m_port;
+
+	int m_threads;
+
+	std::atomic<bool> m_stopped;
+};
+
+#endif SERVER_H
@@ -0,0 +1,96 @@
+#ifndef SQUARE_H
+#define SQUARE_H
+
+#include <string>
+#include <stdexcept>
+
+#include "constants.h"
+#include "geometry.h"
+
+
+/*
+	@brief		geometry the game, the search and saves are built for (see Geometry)
+*/
+typedef Geometry<BOARD_SIZE> BoardGeometry;
+
+const int SQUARES = BoardGeometry::SQUARES;
+
+/*
+	@param		size		number of rows and columns of a board
+
+	@return		true if BasicBoard (with its tables) and BasicPerft are built for size x size boards
+*/
+inline bool isBoardSize(const int& size) {
+	return size == 8 || size == 10 || size == 12;
+}
+
+/*
+	@brief		calls f with the Geometry of a board size chosen at run time, e.g. the size of a ruleset
+
+	@param		size		number of rows and columns, see isBoardSize
+	@param		f			callable taking any Geometry by value
+
+	@return		what f returns
+
+	@throw		invalid_argument if boards aren't built for size
+*/
+template <class F>
+inline auto withGeometry(const int& size, F f) -> decltype(f(BoardGeometry())) {
+	switch (size) {
+	case 8:
+		return f(Geometry<8>());
+	case 10:
+		return f(Geometry<10>());
+	case 12:
+		return f(Geometry<12>());
+	}
+	throw std::invalid_argument("Boards of " + std::to_string(size) + "x" + std::to_string(size) + " are not supported.");
+}
+
+/*
+	@param		row			row in board array
+	@param		col			column in board array
+
+	@return		square at row and col, or NO_SQUARE if either is off the board
+*/
+inline Square makeSquare(const int& row, const int& col) {
+	return BoardGeometry::makeSquare(row, col);
+}
+
+/*
+	@param		sq			square on the board
+
+	@return		row of sq in board array
+*/
+inline int rowOf(const Square& sq) {
+	return BoardGeometry::rowOf(sq);
+}
+
+/*
+	@param		sq			square on the board
+
+	@return		column of sq in board array
+*/
+inline int colOf(const Square& sq) {
+	return BoardGeometry::colOf(sq);
+}
+
+/*
+	@param		pos			position in algebraic notation, e.g. "e4"
+
+	@return		square of pos, or NO_SQUARE if pos is not contained within the board dimensions
+*/
+inline Square toSquare(const std::string& pos) {
+	return BoardGeometry::toSquare(pos, FIRST_COL, FIRST_ROW);
+}
+
+/*
+	@param		sq			square on the board
+
+	@return		sq in algebraic notation, e.g. "e4"
+*/
+inline std::string toAlgebraic(const Square& sq) {
+	return BoardGeometry::toAlgebraic(sq, FIRST_COL, FIRST_ROW);
+}
+
+#endif SQUARE_H
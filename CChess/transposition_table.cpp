@@ -0,0 +1,224 @@
+#include <iostream>		// std::cout
+#include <new>			// placement new, std::bad_alloc
+#include <cstdlib>		// posix_memalign, free
+#ifdef _WIN32
+#include <malloc.h>		// _aligned_malloc
+#endif
+#ifdef __linux__
+#include <sys/mman.h>	// mmap, madvise
+#endif
+
+#include "transposition_table.h"
+
+
+const size_t TranspositionTable::DEFAULT_MEGABYTES;
+const int TranspositionTable::BUCKET_SLOTS;
+
+namespace {
+	//bit layout of a packed entry
+	const int CURRENT_SHIFT = 0;	//8 bits, 0xFF for no move
+	const int FUTURE_SHIFT = 8;		//8 bits
+	const int TYPE_SHIFT = 16;		//2 bits
+	const int BOUND_SHIFT = 18;		//2 bits, BOUND_NONE marks an empty slot
+	const int DEPTH_SHIFT = 20;		//8 bits
+	const int GEN_SHIFT = 28;		//8 bits
+	const int SCORE_SHIFT = 36;		//16 bits, two's complement
+	const uint64_t MASK_8 = 0xFF;
+	const unsigned GEN_MASK = 0xFF;
+	const size_t HUGE_PAGE = 2 * 1024 * 1024;
+}
+
+
+// Public
+// ------
+TranspositionTable::TranspositionTable(const size_t& megabytes, const bool& hugePages)
+	: m_buckets(nullptr), m_bucketCount(0), m_mapped(false), m_generation(0) {
+	resize(megabytes, hugePages);
+}
+
+TranspositionTable::~TranspositionTable() {
+	release();
+}
+
+void TranspositionTable::resize(const size_t& megabytes, const bool& hugePages) {
+	release();
+	size_t buckets = 1;
+	while (buckets * 2 * sizeof(Bucket) <= (megabytes ? megabytes : 1) * 1024 * 1024) {
+		buckets *= 2;
+	}
+	size_t size = buckets * sizeof(Bucket);
+	void* memory = nullptr;
+#ifdef __linux__
+	if (hugePages) {
+		//mmap only aligns to normal pages, but a huge page must start on a 2 MB boundary:
+		//map an extra huge page, then unmap the slack before and after the aligned part
+		size_t mapped = (size + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+		void* region = mmap(nullptr, mapped + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (region != MAP_FAILED) {
+			char* begin = static_cast<char*>(region);
+			char* aligned = begin + (HUGE_PAGE - reinterpret_cast<uintptr_t>(begin) % HUGE_PAGE) % HUGE_PAGE;
+			if (aligned > begin) {
+				munmap(begin, aligned - begin);
+			}
+			if (aligned + mapped < begin + mapped + HUGE_PAGE) {
+				munmap(aligned + mapped, begin + HUGE_PAGE - aligned);
+			}
+			memory = aligned;
+			madvise(memory, mapped, MADV_HUGEPAGE);	//a hint: falls back to normal pages silently
+			m_mapped = true;
+		}
+	}
+#endif
+	if (!memory) {
+#ifdef _WIN32
+		memory = _aligned_malloc(size, alignof(Bucket));
+#else
+		if (posix_memalign(&memory, alignof(Bucket), size) != 0) {
+			memory = nullptr;
+		}
+#endif
+	}
+	if (!memory) {
+		throw std::bad_alloc();
+	}
+	m_buckets = static_cast<Bucket*>(memory);
+	m_bucketCount = buckets;
+	for (size_t i = 0; i < m_bucketCount; ++i) {
+		new (&m_buckets[i]) Bucket;
+	}
+	clear();
+}
+
+void TranspositionTable::clear() {
+	for (size_t i = 0; i < m_bucketCount; ++i) {
+		for (Slot& slot : m_buckets[i].slots) {
+			slot.keyXorData.store(0, std::memory_order_relaxed);
+			slot.data.store(0, std::memory_order_relaxed);
+		}
+	}
+	m_generation = 0;
+	m_probes = m_hits = m_stores = m_collisions = 0;
+}
+
+void TranspositionTable::newSearch() {
+	m_generation = (m_generation + 1) & GEN_MASK;
+}
+
+bool TranspositionTable::probe(const uint64_t& key, TTEntry& entry) {
+	m_probes.fetch_add(1, std::memory_order_relaxed);
+	Bucket& bucket = m_buckets[key & (m_bucketCount - 1)];
+	for (Slot& slot : bucket.slots) {
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+		if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key && ((data >> BOUND_SHIFT) & 3) != BOUND_NONE) {
+			entry = unpack(data);
+			m_hits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
+
+void TranspositionTable::store(const uint64_t& key, const TTEntry& entry) {
+	m_stores.fetch_add(1, std::memory_order_relaxed);
+	Bucket& bucket = m_buckets[key & (m_bucketCount - 1)];
+	Slot* replace = nullptr;
+	int worst = 0;
+	for (Slot& slot : bucket.slots) {
+		uint64_t data = slot.data.load(std::memory_order_relaxed);
+		if (((data >> BOUND_SHIFT) & 3) == BOUND_NONE) {	//empty
+			replace = &slot;
+			break;
+		}
+		if ((slot.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {	//same position
+			replace = &slot;
+			break;
+		}
+		//deeper and more recent entries are worth more
+		int age = int((m_generation - unsigned((data >> GEN_SHIFT) & MASK_8)) & GEN_MASK);
+		int value = int((data >> DEPTH_SHIFT) & MASK_8) - 8 * age;
+		if (!replace || value < worst) {
+			replace = &slot;
+			worst = value;
+		}
+	}
+	uint64_t old = replace->data.load(std::memory_order_relaxed);
+	if (((old >> BOUND_SHIFT) & 3) != BOUND_NONE && (replace->keyXorData.load(std::memory_order_relaxed) ^ old) != key) {
+		m_collisions.fetch_add(1, std::memory_order_relaxed);
+	}
+	uint64_t data = pack(entry, m_generation);
+	replace->data.store(data, std::memory_order_relaxed);
+	replace->keyXorData.store(key ^ data, std::memory_order_relaxed);
+}
+
+size_t TranspositionTable::bytes() const {
+	return m_bucketCount * sizeof(Bucket);
+}
+
+int TranspositionTable::hashfull() const {
+	int used = 0, sampled = 0;
+	for (size_t i = 0; i < m_bucketCount && sampled < 1000; ++i) {
+		for (const Slot& slot : m_buckets[i].slots) {
+			uint64_t data = slot.data.load(std::memory_order_relaxed);
+			if (((data >> BOUND_SHIFT) & 3) != BOUND_NONE && ((data >> GEN_SHIFT) & MASK_8) == m_generation) {
+				++used;
+			}
+			++sampled;
+		}
+	}
+	return sampled ? used * 1000 / sampled : 0;
+}
+
+void TranspositionTable::printStats() const {
+	uint64_t probes = m_probes, hits = m_hits, stores = m_stores, collisions = m_collisions;
+	std::cout << "Hash:\t\t" << bytes() / (1024 * 1024) << " MB (" << m_bucketCount * BUCKET_SLOTS << " entries"
+		<< (m_mapped ? ", huge pages requested" : "") << ")" << std::endl
+		<< "Hashfull:\t" << hashfull() << " permille" << std::endl
+		<< "Probes:\t\t" << probes << " (" << (probes ? hits * 100 / probes : 0) << "% hits)" << std::endl
+		<< "Stores:\t\t" << stores << " (" << (stores ? collisions * 100 / stores : 0) << "% evicted another position)" << std::endl;
+}
+
+// Private
+// -------
+uint64_t TranspositionTable::pack(const TTEntry& entry, const unsigned& generation) {
+	int depth = entry.depth < 0 ? 0 : (entry.depth > 255 ? 255 : entry.depth);
+	uint64_t current = (entry.best.current == NO_SQUARE) ? MASK_8 : uint64_t(entry.best.current);
+	return (current << CURRENT_SHIFT)
+		| (uint64_t(entry.best.future & MASK_8) << FUTURE_SHIFT)
+		| (uint64_t(entry.best.type & 3) << TYPE_SHIFT)
+		| (uint64_t(entry.bound & 3) << BOUND_SHIFT)
+		| (uint64_t(depth) << DEPTH_SHIFT)
+		| (uint64_t(generation & GEN_MASK) << GEN_SHIFT)
+		| (uint64_t(uint16_t(int16_t(entry.score))) << SCORE_SHIFT);
+}
+
+TTEntry TranspositionTable::unpack(const uint64_t& data) {
+	TTEntry entry;
+	uint64_t current = (data >> CURRENT_SHIFT) & MASK_8;
+	entry.best.current = (current == MASK_8) ? NO_SQUARE : Square(current);
+	entry.best.future = Square((data >> FUTURE_SHIFT) & MASK_8);
+	entry.best.type = MoveType((data >> TYPE_SHIFT) & 3);
+	entry.bound = Bound((data >> BOUND_SHIFT) & 3);
+	entry.depth = int((data >> DEPTH_SHIFT) & MASK_8);
+	entry.score = int(int16_t(uint16_t((data >> SCORE_SHIFT) & 0xFFFF)));
+	return entry;
+}
+
+void TranspositionTable::release() {
+	if (!m_buckets) {
+		return;
+	}
+#ifdef __linux__
+	if (m_mapped) {
+		munmap(m_buckets, (bytes() + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE);
+		m_buckets = nullptr;
+		m_mapped = false;
+		return;
+	}
+#endif
+#ifdef _WIN32
+	_aligned_free(m_buckets);
+#else
+	free(m_buckets);
+#endif
+	m_buckets = nullptr;
+}
@@ -0,0 +1,168 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "move.h"
+
+
+/*
+	@brief		what a stored score says about the true score of a position
+*/
+enum Bound {
+	BOUND_NONE = 0,
+	BOUND_UPPER = 1,	//search failed low: true score <= score
+	BOUND_LOWER = 2,	//search failed high: true score >= score
+	BOUND_EXACT = 3
+};
+
+/*
+	@brief		unpacked contents of a transposition table entry
+*/
+struct TTEntry {
+	int depth;
+	Bound bound;
+	int score;
+	Move best;			//current is NO_SQUARE if there is no best move
+};
+
+/*
+	@brief		fixed-size hash table of search results shared by any number of threads without locks
+				entries are 16 bytes (key XOR data, data), four to a 64 byte bucket so a probe touches one cache line;
+				a torn write from a racing thread fails the XOR check and simply reads as a miss
+*/
+class TranspositionTable {
+public:
+	/*
+		@param		megabytes	size of table, rounded down to a power of two number of buckets
+		@param		hugePages	if true, ask the OS to back the table with huge pages (Linux only, ignored elsewhere)
+	*/
+	TranspositionTable(const size_t& megabytes = DEFAULT_MEGABYTES, const bool& hugePages = false);
+
+	~TranspositionTable();
+
+	TranspositionTable(const TranspositionTable&) = delete;
+	TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+	/*
+		@brief		reallocates the table, discarding every entry (not thread safe)
+
+		@param		megabytes	size of table, rounded down to a power of two number of buckets
+		@param		hugePages	if true, ask the OS to back the table with huge pages (Linux only, ignored elsewhere)
+	*/
+	void resize(const size_t& megabytes, const bool& hugePages = false);
+
+	/*
+		@brief		empties every entry and resets the counters (not thread safe)
+	*/
+	void clear();
+
+	/*
+		@brief		starts a new search, so entries from older searches are replaced first
+	*/
+	void newSearch();
+
+	/*
+		@param		key			hash of position
+		@param		entry		receives the stored entry if found
+
+		@return		true if an entry for key was found
+	*/
+	bool probe(const uint64_t& key, TTEntry& entry);
+
+	/*
+		@param		key			hash of position
+		@param		entry		result to store; replaces the entry for key, an empty one, or the least useful one in its bucket
+	*/
+	void store(const uint64_t& key, const TTEntry& entry);
+
+	/*
+		@return		size of table in bytes
+	*/
+	size_t bytes() const;
+
+	/*
+		@return		permille of entries (from a sample) written during the current search
+	*/
+	int hashfull() const;
+
+	/*
+		@brief		prints size, fill and hit/collision counters to standard output
+	*/
+	void printStats() const;
+
+	static const size_t DEFAULT_MEGABYTES = 16;
+
+private:
+	/*
+		@brief		one entry: key is stored XORed with data so a half-written entry is detected
+	*/
+	struct Slot {
+		std::atomic<uint64_t> keyXorData;
+		std::atomic<uint64_t> data;
+	};
+
+	static const int BUCKET_SLOTS = 4;
+
+	/*
+		@brief		one cache line of slots
+	*/
+	struct alignas(64) Bucket {
+		Slot slots[BUCKET_SLOTS];
+	};
+
+	/*
+		@param		entry		entry to pack
+		@param		generation	search the entry was stored in
+
+		@return		entry packed into 64 bits
+	*/
+	static uint64_t pack(const TTEntry& entry, const unsigned& generation);
+
+	/*
+		@param		data		packed entry
+
+		@return		unpacked entry
+	*/
+	static TTEntry unpack(const uint64_t& data);
+
+	/*
+		@brief		frees m_buckets
+	*/
+	void release();
+
+	// Member variables
+	// ----------------
+	/*
+		@brief		table memory (from mmap, aligned to a huge page, if m_mapped; otherwise an aligned allocation)
+	*/
+	Bucket* m_buckets;
+
+	/*
+		@brief		number of buckets, a power of two
+	*/
+	size_t m_bucketCount;
+
+	/*
+		@brief		true if m_buckets was obtained with mmap
+	*/
+	bool m_mapped;
+
+	/*
+		@brief		search counter stored in entries, used to age them out
+	*/
+	unsigned m_generation;
+
+	/*
+		@brief		counters for sizing the table: lookups, lookups that found their key,
+					stores, and stores that evicted a different position
+	*/
+	alignas(64) std::atomic<uint64_t> m_probes;
+	std::atomic<uint64_t> m_hits;
+	std::atomic<uint64_t> m_stores;
+	std::atomic<uint64_t> m_collisions;
+};
+
+#endif TRANSPOSITION_TABLE_H
@@ -0,0 +1,178 @@
+#include <iostream>		// std::cout
+#include <fstream>		// std::ifstream, std::ofstream
+#include <filesystem>	// std::filesystem::directory_iterator
+#include <thread>		// std::thread
+#include <atomic>		// std::atomic
+#include <chrono>		// std::chrono::steady_clock
+#include <algorithm>	// std::sort
+
+#include "constants.h"
+#include "validator.h"
+
+
+// Public
+// ------
+Validator::Validator(const int& threads) : m_threads((threads > 1) ? threads : 1) {
+}
+
+std::vector<ValidationResult> Validator::validateDirectory(const std::string& directory) {
+	std::vector<std::string> files;
+	try {
+		for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+			if (entry.is_regular_file() && entry.path().extension() == JSON_EXT) {
+				files.push_back(entry.path().string());
+			}
+		}
+	} catch (const std::filesystem::filesystem_error& e) {
+		throw std::invalid_argument(e.what());
+	}
+	std::sort(files.begin(), files.end());
+
+	//workers take the next file until none are left; each writes only its own results
+	std::vector<ValidationResult> results(files.size());
+	std::atomic<size_t> next(0);
+	auto work = [&]() {
+		Board board;
+		for (size_t i = next++; i < files.size(); i = next++) {
+			results[i] = validateFile(board, files[i]);
+		}
+	};
+	std::vector<std::thread> workers;
+	for (int t = 1; t < m_threads; ++t) {
+		workers.emplace_back(work);
+	}
+	work();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	return results;
+}
+
+ValidationResult Validator::validateFile(Board& board, const std::string& path) {
+	auto start = std::chrono::steady_clock::now();
+	ValidationResult result = { path, true, -1, "", 0 };
+	int index = -1;	//no move can be blamed until the rules are set up
+	try {
+		std::ifstream ifs(path);
+		if (!ifs.is_open()) {
+			throw std::invalid_argument("File cannot be opened.");
+		}
+		const json file = json::parse(ifs);
+		board.reset(file.at(SAVE_RULES).get<std::string>());
+		index = 0;
+		int turn = FIRST_TURN;
+		const json rounds = (file.find(SAVE_ROUND) != file.end()) ? file.at(SAVE_ROUND) : json::object();	//absent if nothing was played
+		for (int i = 0; i < int(rounds.size()); ++i) {	//rounds
+			for (const std::string& side : { SAVE_WHITE_TURN, SAVE_BLACK_TURN }) {	//turns
+				for (const auto& m : rounds.at(std::to_string(i)).at(side)) {	//moves
+					Square current = toSquare(m.at(0).get<std::string>()), future = toSquare(m.at(1).get<std::string>());
+					MoveStatus status = board.tryMove(current, future, turn);
+					if (status != MOVE_OK) {
+						throw std::invalid_argument(board.describe(status, current));	//ends the file, so unwinds once at most
+					}
+					turn = !turn;
+					++index;
+				}
+			}
+		}
+	} catch (const std::invalid_argument& e) {	//illegal move, or rules that can't be used
+		result.valid = false;
+		result.badMove = index;
+		result.reason = e.what();
+	} catch (const std::exception& e) {	//not json, or not a save
+		result.valid = false;
+		result.reason = e.what();
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+ValidationResult Validator::validateRecord(Board& board, const GameRecordView& game, const std::string& name) {
+	auto start = std::chrono::steady_clock::now();
+	ValidationResult result = { name, true, -1, "", 0 };
+	int index = -1;
+	try {
+		board.reset(std::string(game.rules));
+		int turn = FIRST_TURN;
+		for (index = 0; index < int(game.count); ++index) {
+			uint16_t m = game.move(uint32_t(index));
+			Square current = GameRecord::current(m), future = GameRecord::future(m);
+			MoveStatus status = board.tryMove(current, future, turn);
+			if (status != MOVE_OK) {	//no exception per bad game of a large database
+				result.valid = false;
+				result.badMove = index;
+				result.reason = board.describe(status, current);
+				break;
+			}
+			turn = !turn;
+		}
+	} catch (const std::invalid_argument& e) {	//illegal move, or rules that can't be used
+		result.valid = false;
+		result.badMove = index;
+		result.reason = e.what();
+	} catch (const std::exception& e) {	//rules file that isn't json
+		result.valid = false;
+		result.reason = e.what();
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+void Validator::writeReport(const std::string& path, const std::string& directory, const std::vector<ValidationResult>& results, const double& seconds) const {
+	json report;
+	report[VALIDATE_DIRECTORY] = directory;
+	report[VALIDATE_THREADS] = m_threads;
+	report[VALIDATE_SECONDS] = seconds;
+	report[VALIDATE_FILES] = json::array();
+	int invalid = 0;
+	for (const ValidationResult& r : results) {
+		json file;
+		file[VALIDATE_FILE] = r.file;
+		file[VALIDATE_VALID] = r.valid;
+		file[VALIDATE_BAD_MOVE] = (r.badMove < 0) ? json() : json(r.badMove);
+		file[VALIDATE_REASON] = r.reason;
+		file[VALIDATE_SECONDS] = r.seconds;
+		report[VALIDATE_FILES].push_back(file);
+		invalid += r.valid ? 0 : 1;
+	}
+	report[VALIDATE_INVALID] = invalid;
+	std::ofstream ofs(path);
+	if (!ofs.is_open()) {
+		throw std::invalid_argument("Report cannot be written to " + path);
+	}
+	ofs << report.dump(4) << std::endl;
+}
+
+int Validator::run(const std::vector<std::string>& args) {
+	if (args.size() > 3) {
+		std::cout << "Usage: " << VALIDATE << " [<directory> [<report> [<threads>]]]" << std::endl;
+		return 1;
+	}
+	std::string directory = (args.size() > 0) ? args[0] : SAVE_DIR;
+	std::string report = (args.size() > 1) ? args[1] : VALIDATE_REPORT + JSON_EXT;
+	try {
+		int threads = (args.size() > 2) ? std::stoi(args[2]) : int(std::thread::hardware_concurrency());
+		Validator validator(threads);
+		auto start = std::chrono::steady_clock::now();
+		std::vector<ValidationResult> results = validator.validateDirectory(directory);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		validator.writeReport(report, directory, results, seconds);
+		int invalid = 0;
+		for (const ValidationResult& r : results) {
+			if (!r.valid) {
+				std::cout << r.file << '\t';
+				if (r.badMove >= 0) {
+					std::cout << "move " << r.badMove << '\t';
+				}
+				std::cout << r.reason << std::endl;
+				++invalid;
+			}
+		}
+		std::cout << results.size() << " files, " << invalid << " invalid, " << seconds << " s with "
+			<< validator.m_threads << " threads. Report written to " << report << std::endl;
+		return invalid ? 1 : 0;
+	} catch (const std::exception& e) {	//unreadable directory, unwritable report, or threads isn't a number (or doesn't fit an int)
+		std::cout << e.what() << std::endl;
+		return 1;
+	}
+}
@@ -0,0 +1,95 @@
+#ifndef VALIDATOR_H
+#define VALIDATOR_H
+
+#include <string>
+#include <vector>
+
+#include "board.h"
+#include "game_record.h"
+
+
+/*
+	@brief		outcome of replaying one save file
+*/
+struct ValidationResult {
+	std::string file;
+	bool valid;
+	int badMove;			//index of the first illegal move counting from 0 over the whole game, -1 if none (or the file is unreadable)
+	std::string reason;		//empty if valid
+	double seconds;			//time taken to read and replay the file
+};
+
+/*
+	@brief		headless bulk validation of save files: every file is replayed on a board owned by one of a pool of threads,
+				so files are independent and throughput grows with the number of threads
+*/
+class Validator {
+public:
+	/*
+		@param		threads		number of worker threads, each with its own board (at least 1)
+	*/
+	Validator(const int& threads);
+
+	/*
+		@param		directory	directory whose .json files are validated
+
+		@return		result of every .json file in directory, sorted by file name
+
+		@throw		std::invalid_argument if directory cannot be read
+	*/
+	std::vector<ValidationResult> validateDirectory(const std::string& directory);
+
+	/*
+		@brief		replays one save file with the same rules as Game::load, without printing anything
+
+		@param		board		board to replay on; reset to the rules of the file
+		@param		path		path of save file
+
+		@return		whether every move was legal, and if not which one and why
+	*/
+	static ValidationResult validateFile(Board& board, const std::string& path);
+
+	/*
+		@brief		replays one game record (such as a game of a GameDatabase) like validateFile
+
+		@param		board		board to replay on; reset to the rules of the record
+		@param		game		view of the record
+		@param		name		name of the game, stored as the file of the result
+
+		@return		whether every move was legal, and if not which one and why
+	*/
+	static ValidationResult validateRecord(Board& board, const GameRecordView& game, const std::string& name);
+
+	/*
+		@brief		writes results as json: a summary followed by one object per file
+
+		@param		path		path of report file
+		@param		directory	directory that was validated
+		@param		results		results of validateDirectory
+		@param		seconds		wall time of the whole validation
+
+		@throw		std::invalid_argument if the report cannot be written
+	*/
+	void writeReport(const std::string& path, const std::string& directory, const std::vector<ValidationResult>& results, const double& seconds) const;
+
+	/*
+		@brief		entry point of the headless validate mode, see main.cpp
+					validate [<directory> [<report> [<threads>]]]		validates every save in directory (SAVE_DIR by default)
+																		and writes a json report (VALIDATE_REPORT by default)
+
+		@param		args		command line arguments following "validate"
+
+		@return		process exit code: 0 if every file was valid
+	*/
+	static int run(const std::vector<std::string>& args);
+
+private:
+	// Member variables
+	// ----------------
+	/*
+		@brief		number of worker threads
+	*/
+	int m_threads;
+};
+
+#endif VALIDATOR_H
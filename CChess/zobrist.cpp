@@ -0,0 +1,38 @@
+#include "zobrist.h"
+
+
+// Public
+// ------
+template <class G>
+BasicZobrist<G>::BasicZobrist(const int& pieces) : m_pieces(pieces) {
+	//splitmix64 from a fixed seed
+	uint64_t state = 0x43436865737321ULL;	//"CChess!"
+	m_keys.resize(pieces * 2 * G::SQUARES + G::SQUARES + 1);
+	for (uint64_t& key : m_keys) {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		key = z ^ (z >> 31);
+	}
+}
+
+template <class G>
+uint64_t BasicZobrist<G>::piece(const int& piece, const int& side, const Square& sq) const {
+	return m_keys[(piece * 2 + side) * G::SQUARES + sq];
+}
+
+template <class G>
+uint64_t BasicZobrist<G>::neverMoved(const Square& sq) const {
+	return m_keys[m_pieces * 2 * G::SQUARES + sq];
+}
+
+template <class G>
+uint64_t BasicZobrist<G>::blackToMove() const {
+	return m_keys.back();
+}
+
+// Instantiations
+// --------------
+template class BasicZobrist<Geometry<8>>;
+template class BasicZobrist<Geometry<10>>;
+template class BasicZobrist<Geometry<12>>;
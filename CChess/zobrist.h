@@ -0,0 +1,59 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include <vector>
+
+#include "square.h"
+
+
+/*
+	@brief		random keys for hashing a position on a board of geometry G: XOR the keys of everything present to get its hash
+				keys come from a fixed seed, so hashes are stable between runs and machines
+*/
+template <class G>
+class BasicZobrist {
+public:
+	/*
+		@param		pieces		number of pieces in the PieceLibrary positions will hold
+	*/
+	BasicZobrist(const int& pieces);
+
+	/*
+		@param		piece		index of piece in PieceLibrary
+		@param		side		enum of White or Black
+		@param		sq			square the piece stands on
+
+		@return		key of piece belonging to side standing on sq
+	*/
+	uint64_t piece(const int& piece, const int& side, const Square& sq) const;
+
+	/*
+		@param		sq			square of a piece that has never moved (and has initial moves)
+
+		@return		key of the never-moved bit of sq
+	*/
+	uint64_t neverMoved(const Square& sq) const;
+
+	/*
+		@return		key included whenever Black is to move
+	*/
+	uint64_t blackToMove() const;
+
+private:
+	// Member variables
+	// ----------------
+	/*
+		@brief		keys for every (piece, side, square), followed by every never-moved square, followed by side to move
+	*/
+	std::vector<uint64_t> m_keys;
+
+	/*
+		@brief		number of pieces keys were generated for
+	*/
+	int m_pieces;
+};
+
+typedef BasicZobrist<BoardGeometry> Zobrist;
+
+#endif ZOBRIST_H